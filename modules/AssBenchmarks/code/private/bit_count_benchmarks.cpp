@@ -0,0 +1,78 @@
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ass/bit/simd_kernels.hpp"
+#include "ass/bit_span.hpp"
+#include "benchmark/benchmark.h"
+
+namespace bit_count_benchmarks
+{
+std::vector<uint64_t> MakeParts(const size_t bytes_count)
+{
+    constexpr unsigned seed = 42;
+    std::mt19937_64 gen(seed);
+    std::vector<uint64_t> parts(bytes_count / sizeof(uint64_t));
+    for (uint64_t& part : parts) part = gen();
+    return parts;
+}
+
+// Baseline: std::popcount per part, what BitSpan does for spans below the kernel threshold
+void BM_PopcountPerPart(benchmark::State& state)
+{
+    const auto parts = MakeParts(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        size_t n = 0;
+        for (const uint64_t part : parts) n += static_cast<size_t>(std::popcount(part));
+        benchmark::DoNotOptimize(n);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+template <ass::simd::SimdLevel level>
+void BM_CountOnesKernel(benchmark::State& state)
+{
+    if (!ass::simd::IsSimdLevelSupported(level))
+    {
+        state.SkipWithError("CPU does not support this instruction set");
+        return;
+    }
+
+    const auto parts = MakeParts(static_cast<size_t>(state.range(0)));
+    const auto* bytes = reinterpret_cast<const unsigned char*>(parts.data());
+    const size_t bytes_count = parts.size() * sizeof(uint64_t);
+    const auto count_ones = ass::simd::GetBitKernels(level).count_ones;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(count_ones(bytes, bytes_count));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// Full path through dynamic BitSpan with runtime dispatch
+void BM_BitSpanCountOnes(benchmark::State& state)
+{
+    auto parts = MakeParts(static_cast<size_t>(state.range(0)));
+    const auto bits = ass::ToBitSpan(std::span{parts}, {.size = parts.size() * 64});
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bits.CountOnes());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+#define ASS_BIT_COUNT_BENCHMARK(...) BENCHMARK(__VA_ARGS__)->RangeMultiplier(8)->Range(256, 1 << 20)
+
+ASS_BIT_COUNT_BENCHMARK(BM_PopcountPerPart);
+ASS_BIT_COUNT_BENCHMARK(BM_CountOnesKernel<ass::simd::SimdLevel::kScalar>)->Name("BM_CountOnesKernel/Scalar");
+ASS_BIT_COUNT_BENCHMARK(BM_CountOnesKernel<ass::simd::SimdLevel::kAvx2>)->Name("BM_CountOnesKernel/Avx2");
+ASS_BIT_COUNT_BENCHMARK(BM_CountOnesKernel<ass::simd::SimdLevel::kAvx512>)->Name("BM_CountOnesKernel/Avx512");
+ASS_BIT_COUNT_BENCHMARK(BM_BitSpanCountOnes);
+
+}  // namespace bit_count_benchmarks
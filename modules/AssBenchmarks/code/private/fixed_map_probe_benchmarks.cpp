@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "ass/fixed_unordered_map.hpp"
+#include "benchmark/benchmark.h"
+
+namespace fixed_map_probe_benchmarks
+{
+inline constexpr size_t kCapacity = 4096;
+
+// Keys are multiples of 8 and hasher is an identity function - typical
+// "good enough" hasher for integers that produces long runs of occupied slots.
+struct IdentityHasher
+{
+    constexpr size_t operator()(const uint32_t key) const noexcept
+    {
+        return key;
+    }
+};
+
+// Keeps only a few low bits of entropy - many keys share the first slot.
+struct TruncatingHasher
+{
+    constexpr size_t operator()(const uint32_t key) const noexcept
+    {
+        return (key >> 3) & 0xFF;
+    }
+};
+
+template <typename Map>
+std::vector<uint32_t> FillMap(Map& map, size_t load_percent)
+{
+    const size_t keys_count = kCapacity * load_percent / 100;
+    std::vector<uint32_t> keys(keys_count);
+    for (size_t i = 0; i != keys_count; ++i)
+    {
+        keys[i] = static_cast<uint32_t>(i * 8);
+    }
+
+    for (const uint32_t key : keys)
+    {
+        map.Add(key, key);
+    }
+
+    return keys;
+}
+
+template <typename Hasher, typename ProbePolicy>
+void BM_Lookup(benchmark::State& state)
+{
+    using Map = ass::FixedUnorderedMap<kCapacity, uint32_t, uint32_t, Hasher, ProbePolicy>;
+    auto map = std::make_unique<Map>();
+    const auto keys = FillMap(*map, static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const uint32_t key : keys)
+        {
+            benchmark::DoNotOptimize(map->Find(key));
+        }
+    }
+
+    std::vector<size_t> probes(keys.size());
+    std::ranges::transform(
+        keys,
+        probes.begin(),
+        [&](const uint32_t key)
+        {
+            return map->CountProbes(key);
+        });
+    std::ranges::sort(probes);
+
+    const double total = static_cast<double>(std::accumulate(probes.begin(), probes.end(), size_t{0}));
+    state.counters["probes_mean"] = total / static_cast<double>(probes.size());
+    state.counters["probes_p99"] = static_cast<double>(probes[probes.size() * 99 / 100]);
+    state.counters["probes_max"] = static_cast<double>(probes.back());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+template <typename Hasher, typename ProbePolicy>
+void BM_Miss(benchmark::State& state)
+{
+    using Map = ass::FixedUnorderedMap<kCapacity, uint32_t, uint32_t, Hasher, ProbePolicy>;
+    auto map = std::make_unique<Map>();
+    const auto keys = FillMap(*map, static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const uint32_t key : keys)
+        {
+            // Odd keys are never added
+            benchmark::DoNotOptimize(map->Find(key + 1));
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+#define ASS_PROBE_BENCHMARK(fn, hasher, policy) \
+    BENCHMARK(fn<hasher, ass::policy>)->Name(#fn "/" #hasher "/" #policy)->Arg(50)->Arg(75)->Arg(90)
+
+ASS_PROBE_BENCHMARK(BM_Lookup, IdentityHasher, LinearProbing);
+ASS_PROBE_BENCHMARK(BM_Lookup, IdentityHasher, QuadraticProbing);
+ASS_PROBE_BENCHMARK(BM_Lookup, IdentityHasher, DoubleHashing);
+ASS_PROBE_BENCHMARK(BM_Lookup, TruncatingHasher, LinearProbing);
+ASS_PROBE_BENCHMARK(BM_Lookup, TruncatingHasher, QuadraticProbing);
+ASS_PROBE_BENCHMARK(BM_Lookup, TruncatingHasher, DoubleHashing);
+ASS_PROBE_BENCHMARK(BM_Miss, IdentityHasher, LinearProbing);
+ASS_PROBE_BENCHMARK(BM_Miss, IdentityHasher, QuadraticProbing);
+ASS_PROBE_BENCHMARK(BM_Miss, IdentityHasher, DoubleHashing);
+
+}  // namespace fixed_map_probe_benchmarks
@@ -0,0 +1,161 @@
+#include <array>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "ass/atomic_fixed_bitset.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+TEST(AtomicFixedBitsetTest, SetReset)
+{
+    AtomicFixedBitset<100> bitset;
+    ASSERT_EQ(bitset.CountOnes(), 0);
+    ASSERT_FALSE(bitset.Set(5));
+    ASSERT_TRUE(bitset.Set(5));
+    ASSERT_TRUE(bitset.Get(5));
+    ASSERT_FALSE(bitset.Set(99));
+    ASSERT_EQ(bitset.CountOnes(), 2);
+    ASSERT_TRUE(bitset.Reset(5));
+    ASSERT_FALSE(bitset.Reset(5));
+    ASSERT_FALSE(bitset.Get(5));
+    ASSERT_EQ(bitset.CountOnes(), 1);
+}
+
+TEST(AtomicFixedBitsetTest, TryClaimFirstZero)
+{
+    AtomicFixedBitset<70> bitset;
+    for (size_t index = 0; index != 70; ++index)
+    {
+        ASSERT_EQ(bitset.TryClaimFirstZero(), index);
+    }
+
+    // Bits past the size are never claimed
+    ASSERT_EQ(bitset.TryClaimFirstZero(), 70);
+
+    bitset.Reset(3);
+    bitset.Reset(66);
+    ASSERT_EQ(bitset.TryClaimFirstZero(64), 66);
+    ASSERT_EQ(bitset.TryClaimFirstZero(64), 3);
+    ASSERT_EQ(bitset.TryClaimFirstZero(64), 70);
+}
+
+TEST(AtomicFixedBitsetTest, ConcurrentClaimAndRelease)
+{
+    constexpr size_t kSlotsCount = 1000;
+    constexpr size_t kThreadsCount = 4;
+    constexpr size_t kIterationsCount = 20'000;
+
+    auto bitset = std::make_unique<AtomicFixedBitset<kSlotsCount>>();
+    auto owners = std::make_unique<std::array<std::atomic<size_t>, kSlotsCount>>();
+    std::atomic<bool> failed = false;
+
+    std::vector<std::thread> threads;
+    for (size_t thread_index = 0; thread_index != kThreadsCount; ++thread_index)
+    {
+        threads.emplace_back(
+            [&, thread_index]
+            {
+                std::vector<size_t> claimed;
+                for (size_t iteration = 0; iteration != kIterationsCount; ++iteration)
+                {
+                    if (claimed.size() < 100)
+                    {
+                        const size_t slot = bitset->TryClaimFirstZero(thread_index * kSlotsCount / kThreadsCount);
+                        if (slot == kSlotsCount) continue;
+
+                        // Nobody else may own a claimed slot
+                        if ((*owners)[slot].exchange(thread_index + 1) != 0) failed = true;
+                        claimed.push_back(slot);
+                    }
+                    else
+                    {
+                        for (const size_t slot : claimed)
+                        {
+                            (*owners)[slot] = 0;
+                            if (!bitset->Reset(slot)) failed = true;
+                        }
+                        claimed.clear();
+                    }
+                }
+
+                for (const size_t slot : claimed)
+                {
+                    (*owners)[slot] = 0;
+                    bitset->Reset(slot);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    ASSERT_EQ(bitset->CountOnes(), 0);
+}
+
+TEST(AtomicBitSpanTest, ExternalParts)
+{
+    std::vector<uint32_t> parts(3, 0);
+    parts[2] = 0xFFFF'0000;  // Bits past the size belong to somebody else
+
+    auto span = ToAtomicBitSpan(std::span{parts}, {.size = 80});
+    ASSERT_EQ(span.GetSize(), 80);
+    ASSERT_EQ(span.GetPartsCount(), 3);
+    ASSERT_EQ(span.CountOnes(), 0);
+
+    ASSERT_FALSE(span.Set(33));
+    ASSERT_TRUE(span.Get(33));
+    ASSERT_EQ(parts[1], 0b10);
+
+    for (size_t index = 0; index != 79; ++index)
+    {
+        span.TryClaimFirstZero();
+    }
+    ASSERT_EQ(span.CountOnes(), 80);
+    ASSERT_EQ(span.TryClaimFirstZero(), 80);
+    ASSERT_EQ(parts[2], 0xFFFF'FFFF);
+
+    ASSERT_TRUE(span.Reset(79));
+    ASSERT_EQ(parts[2], 0xFFFF'7FFF);
+    ASSERT_EQ(span.TryClaimFirstZero(70), 79);
+}
+
+TEST(AtomicBitSpanTest, ConcurrentSet)
+{
+    constexpr size_t kSize = 4096;
+    constexpr size_t kThreadsCount = 4;
+    std::vector<uint64_t> parts(kSize / 64, 0);
+    const auto span = ToAtomicBitSpan(std::span{parts}, {.size = kSize});
+
+    // Every bit is set by several threads but reported as previously unset exactly once
+    std::atomic<size_t> first_sets = 0;
+    std::vector<std::thread> threads;
+    for (size_t thread_index = 0; thread_index != kThreadsCount; ++thread_index)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                size_t n = 0;
+                for (size_t index = 0; index != kSize; ++index)
+                {
+                    n += span.Set(index, std::memory_order_relaxed) ? 0 : 1;
+                }
+                first_sets += n;
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(first_sets, kSize);
+    ASSERT_EQ(span.CountOnes(), kSize);
+}
+}  // namespace ass
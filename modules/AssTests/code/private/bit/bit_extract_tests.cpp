@@ -0,0 +1,180 @@
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ass/bit/bit_extract.hpp"
+#include "ass/bit_span.hpp"
+#include "ass/fixed_bitset.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+template <size_t kSize, typename Part>
+FixedBitset<kSize, Part> ReferenceExtract(const FixedBitset<kSize, Part>& bits, const FixedBitset<kSize, Part>& mask)
+{
+    FixedBitset<kSize, Part> result;
+    size_t out_index = 0;
+    for (size_t index = 0; index != kSize; ++index)
+    {
+        if (mask.Get(index)) result.Set(out_index++, bits.Get(index));
+    }
+    return result;
+}
+
+template <size_t kSize, typename Part>
+FixedBitset<kSize, Part> ReferenceDeposit(const FixedBitset<kSize, Part>& bits, const FixedBitset<kSize, Part>& mask)
+{
+    FixedBitset<kSize, Part> result;
+    size_t in_index = 0;
+    for (size_t index = 0; index != kSize; ++index)
+    {
+        if (mask.Get(index)) result.Set(index, bits.Get(in_index++));
+    }
+    return result;
+}
+
+template <size_t kSize, typename Part>
+FixedBitset<kSize, Part> MakeRandomBitset(std::mt19937& gen, const double density)
+{
+    std::bernoulli_distribution distribution(density);
+    FixedBitset<kSize, Part> bits;
+    for (size_t index = 0; index != kSize; ++index)
+    {
+        bits.Set(index, distribution(gen));
+    }
+    return bits;
+}
+
+template <size_t kSize, typename Part>
+void CheckRandomExtractDeposit()
+{
+    constexpr unsigned seed = 7;
+    std::mt19937 gen(seed);
+    for (const double density : {0.0, 0.05, 0.5, 0.95, 1.0})
+    {
+        for (size_t iteration = 0; iteration != 20; ++iteration)
+        {
+            const auto bits = MakeRandomBitset<kSize, Part>(gen, 0.5);
+            const auto mask = MakeRandomBitset<kSize, Part>(gen, density);
+            ASSERT_EQ(bits.ExtractBits(mask).XorCount(ReferenceExtract(bits, mask)), 0);
+            ASSERT_EQ(bits.DepositBits(mask).XorCount(ReferenceDeposit(bits, mask)), 0);
+            ASSERT_EQ(bits.ExtractBits(mask).DepositBits(mask).XorCount(bits & mask), 0);
+        }
+    }
+}
+
+TEST(BitExtractTest, FixedBitsetMatchesReference)
+{
+    CheckRandomExtractDeposit<1, uint8_t>();
+    CheckRandomExtractDeposit<13, uint8_t>();
+    CheckRandomExtractDeposit<64, uint64_t>();
+    CheckRandomExtractDeposit<100, uint16_t>();
+    CheckRandomExtractDeposit<200, uint32_t>();
+    CheckRandomExtractDeposit<1000, uint64_t>();
+}
+
+TEST(BitExtractTest, Constexpr)
+{
+    constexpr auto bits = []
+    {
+        FixedBitset<20> b;
+        b.SetRange(4, 8);
+        b.Set(17, true);
+        return b;
+    }();
+    constexpr auto mask = []
+    {
+        FixedBitset<20> m;
+        m.SetRange(6, 18);
+        return m;
+    }();
+
+    constexpr auto extracted = bits.ExtractBits(mask);
+    static_assert(extracted.CountOnes() == 3);
+    static_assert(extracted.Get(0) && extracted.Get(1) && extracted.Get(11));
+
+    constexpr auto deposited = extracted.DepositBits(mask);
+    static_assert(deposited.XorCount(bits & mask) == 0);
+}
+
+TEST(BitExtractTest, PortablePartMatchesHardware)
+{
+    constexpr unsigned seed = 3;
+    std::mt19937_64 gen(seed);
+    for (size_t iteration = 0; iteration != 1000; ++iteration)
+    {
+        const uint64_t value = gen();
+        const uint64_t mask = gen() & gen();
+        const uint64_t extracted = bit_extract_detail::ExtractPartPortable(value, mask);
+        ASSERT_EQ(bit_extract_detail::DepositPartPortable(extracted, mask), value & mask);
+#if ASS_BIT_EXTRACT_BMI2
+        if (bit_extract_detail::HasBmi2())
+        {
+            ASSERT_EQ(bit_extract_detail::ExtractPartBmi2(value, mask), extracted);
+            ASSERT_EQ(
+                bit_extract_detail::DepositPartBmi2(value, mask),
+                bit_extract_detail::DepositPartPortable(value, mask));
+        }
+#endif
+    }
+}
+
+TEST(BitExtractTest, BitSpan)
+{
+    constexpr size_t size = 300;
+    std::vector<uint64_t> bits_parts(5);
+    std::vector<uint64_t> mask_parts(5);
+    const auto bits = ToBitSpan(std::span{bits_parts}, {.size = size});
+    const auto mask = ToBitSpan(std::span{mask_parts}, {.size = size});
+    for (size_t index = 0; index != size; ++index)
+    {
+        bits.Set(index, index % 3 == 0);
+        mask.Set(index, index % 2 == 0);
+    }
+
+    // Every other bit is selected and every third of them is set
+    std::vector<uint64_t> out_parts(3, ~uint64_t{0});
+    const auto out = ToBitSpan(std::span{out_parts}, {.size = 160});
+    ASSERT_EQ(bits.ExtractBits(mask, out), 150);
+    for (size_t index = 0; index != 160; ++index)
+    {
+        ASSERT_EQ(out.Get(index), index < 150 && index % 3 == 0) << index;
+    }
+    // Bits past the destination size are not touched
+    ASSERT_EQ(out_parts[2] >> 32, 0xFFFF'FFFFu);
+
+    std::vector<uint64_t> back_parts(5, ~uint64_t{0});
+    const auto back = ToBitSpan(std::span{back_parts}, {.size = size});
+    out.DepositBits(mask, back);
+    for (size_t index = 0; index != size; ++index)
+    {
+        ASSERT_EQ(back.Get(index), index % 6 == 0) << index;
+    }
+
+    // Extraction in place
+    bits.ExtractBits(mask, bits);
+    for (size_t index = 0; index != size; ++index)
+    {
+        ASSERT_EQ(bits.Get(index), index < 150 && index % 3 == 0) << index;
+    }
+}
+
+TEST(BitExtractTest, BitSpanWithShortSource)
+{
+    std::vector<uint8_t> source_parts{0b101};
+    const auto source = ToBitSpan(std::span{source_parts}, {.size = 3});
+
+    FixedBitset<40, uint8_t> mask;
+    mask.SetRange(10, 30);
+    FixedBitset<40, uint8_t> out;
+    out.Fill(true);
+    source.DepositBits(mask, ToBitSpan<{.size = 40}>(out.GetParts()));
+
+    // Source bits past its size read as zeros
+    FixedBitset<40, uint8_t> expected;
+    expected.Set(10, true);
+    expected.Set(12, true);
+    ASSERT_EQ(out.XorCount(expected), 0);
+}
+}  // namespace ass
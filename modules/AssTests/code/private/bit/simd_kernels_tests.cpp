@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <random>
+#include <vector>
+
+#include "ass/bit/simd_kernels.hpp"
+#include "gtest/gtest.h"
+
+namespace ass::simd
+{
+class SimdKernelsTest : public testing::TestWithParam<SimdLevel>
+{
+};
+
+TEST_P(SimdKernelsTest, MatchScalar)
+{
+    const SimdLevel level = GetParam();
+    if (!IsSimdLevelSupported(level))
+    {
+        GTEST_SKIP() << "CPU does not support this instruction set";
+    }
+
+    const BitKernels kernels = GetBitKernels(level);
+    const BitKernels scalar = GetBitKernels(SimdLevel::kScalar);
+
+    constexpr unsigned seed = 42;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<unsigned> byte_distribution(0, 255);
+
+    // Sizes around vector widths and odd offsets to exercise unaligned loads and tails
+    for (size_t offset = 0; offset != 3; ++offset)
+    {
+        for (size_t bytes_count : {0, 1, 7, 8, 15, 16, 31, 32, 33, 63, 64, 65, 127, 128, 200, 511, 512, 513, 1000, 5000})
+        {
+            std::vector<unsigned char> a(bytes_count + offset);
+            std::vector<unsigned char> b(bytes_count + offset);
+            std::ranges::generate(
+                a,
+                [&]
+                {
+                    return static_cast<unsigned char>(byte_distribution(gen));
+                });
+            std::ranges::generate(
+                b,
+                [&]
+                {
+                    return static_cast<unsigned char>(byte_distribution(gen));
+                });
+
+            ASSERT_EQ(
+                kernels.count_ones(a.data() + offset, bytes_count),
+                scalar.count_ones(a.data() + offset, bytes_count));
+            ASSERT_EQ(
+                kernels.xor_count_ones(a.data() + offset, b.data() + offset, bytes_count),
+                scalar.xor_count_ones(a.data() + offset, b.data() + offset, bytes_count));
+
+            auto check_binary = [&](auto kernel_fn, auto scalar_fn)
+            {
+                auto expected = a;
+                auto actual = a;
+                scalar_fn(expected.data() + offset, b.data() + offset, bytes_count);
+                kernel_fn(actual.data() + offset, b.data() + offset, bytes_count);
+                return expected == actual;
+            };
+
+            ASSERT_TRUE(check_binary(kernels.and_inplace, scalar.and_inplace)) << bytes_count;
+            ASSERT_TRUE(check_binary(kernels.or_inplace, scalar.or_inplace)) << bytes_count;
+            ASSERT_TRUE(check_binary(kernels.xor_inplace, scalar.xor_inplace)) << bytes_count;
+
+            auto expected = a;
+            auto actual = a;
+            scalar.not_inplace(expected.data() + offset, bytes_count);
+            kernels.not_inplace(actual.data() + offset, bytes_count);
+            ASSERT_EQ(expected, actual) << bytes_count;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllLevels,
+    SimdKernelsTest,
+    testing::Values(SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2, SimdLevel::kAvx512));
+
+TEST(SimdKernelsTest, ScalarCountOnes)
+{
+    std::vector<unsigned char> data(100, 0b1010'0001);
+    ASSERT_EQ(GetBitKernels(SimdLevel::kScalar).count_ones(data.data(), data.size()), 300);
+    ASSERT_EQ(GetBitKernels().count_ones(data.data(), data.size()), 300);
+}
+
+// Long inputs go through every level of the carry-save adder tree
+TEST(SimdKernelsTest, LargeCountOnes)
+{
+    for (const unsigned char byte : std::to_array<unsigned char>({0x00, 0xFF, 0x80, 0x5A}))
+    {
+        std::vector<unsigned char> data(100'003, byte);
+        const size_t expected = data.size() * static_cast<size_t>(std::popcount(byte));
+        ASSERT_EQ(GetBitKernels().count_ones(data.data(), data.size()), expected);
+    }
+}
+}  // namespace ass::simd
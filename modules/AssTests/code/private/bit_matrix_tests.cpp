@@ -0,0 +1,132 @@
+#include <array>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "ass/bit_matrix.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+BitMatrix MakeRandomMatrix(const size_t rows_count, const size_t columns_count, const double density)
+{
+    constexpr unsigned seed = 17;
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution distribution(density);
+    BitMatrix matrix(rows_count, columns_count);
+    for (size_t row = 0; row != rows_count; ++row)
+    {
+        for (size_t column = 0; column != columns_count; ++column)
+        {
+            matrix.Set(row, column, distribution(gen));
+        }
+    }
+    return matrix;
+}
+
+TEST(BitMatrixTest, Transpose64)
+{
+    constexpr unsigned seed = 1;
+    std::mt19937_64 gen(seed);
+    std::array<uint64_t, 64> block{};
+    for (uint64_t& row : block) row = gen();
+
+    auto transposed = block;
+    bit_matrix_detail::Transpose64(transposed);
+    for (size_t row = 0; row != 64; ++row)
+    {
+        for (size_t column = 0; column != 64; ++column)
+        {
+            ASSERT_EQ((block[row] >> column) & 1, (transposed[column] >> row) & 1);
+        }
+    }
+}
+
+TEST(BitMatrixTest, Transposed)
+{
+    for (const auto& [rows_count, columns_count] : std::vector<std::pair<size_t, size_t>>{
+             {1, 1},
+             {64, 64},
+             {100, 130},
+             {700, 3},
+             {5, 513},
+             {0, 10}})
+    {
+        const BitMatrix matrix = MakeRandomMatrix(rows_count, columns_count, 0.3);
+        const BitMatrix transposed = matrix.Transposed();
+        ASSERT_EQ(transposed.GetRowsCount(), columns_count);
+        ASSERT_EQ(transposed.GetColumnsCount(), rows_count);
+        for (size_t row = 0; row != rows_count; ++row)
+        {
+            for (size_t column = 0; column != columns_count; ++column)
+            {
+                ASSERT_EQ(matrix.Get(row, column), transposed.Get(column, row));
+            }
+        }
+        ASSERT_EQ(transposed.Transposed(), matrix);
+    }
+}
+
+TEST(BitMatrixTest, RowViews)
+{
+    BitMatrix matrix(3, 1000);
+    matrix.GetRow(0).SetRange(0, 600);
+    matrix.GetRow(1).SetRange(500, 1000);
+    matrix.OrRow(2, 0);
+    matrix.OrRow(2, 1);
+    ASSERT_TRUE(matrix.GetRow(2).All());
+    ASSERT_EQ(matrix.GetRow(0).AndCount(matrix.GetRow(1)), 100);
+
+    const BitMatrix& const_matrix = matrix;
+    ASSERT_EQ(const_matrix.GetRow(1).CountOnes(), 500);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(&const_matrix.GetRow(1).GetPart(0)) % 64, 0);
+}
+
+TEST(BitMatrixTest, TransitiveClosureOfChain)
+{
+    constexpr size_t nodes_count = 300;
+    BitMatrix graph(nodes_count, nodes_count);
+    for (size_t node = 0; node + 1 != nodes_count; ++node)
+    {
+        graph.Set(node, node + 1, true);
+    }
+
+    graph.TransitiveClosure();
+    for (size_t from = 0; from != nodes_count; ++from)
+    {
+        for (size_t to = 0; to != nodes_count; ++to)
+        {
+            ASSERT_EQ(graph.Get(from, to), from < to);
+        }
+    }
+}
+
+TEST(BitMatrixTest, TransitiveClosureMatchesSearch)
+{
+    constexpr size_t nodes_count = 200;
+    BitMatrix graph = MakeRandomMatrix(nodes_count, nodes_count, 0.008);
+
+    // Depth first search from every node over the original edges
+    BitMatrix expected(nodes_count, nodes_count);
+    for (size_t from = 0; from != nodes_count; ++from)
+    {
+        std::vector<size_t> stack{from};
+        while (!stack.empty())
+        {
+            const size_t node = stack.back();
+            stack.pop_back();
+            graph.GetRow(node).ForEachSetBit(
+                [&](const size_t to)
+                {
+                    if (expected.Get(from, to)) return;
+                    expected.Set(from, to, true);
+                    stack.push_back(to);
+                });
+        }
+    }
+
+    graph.TransitiveClosure();
+    ASSERT_EQ(graph, expected);
+}
+}  // namespace ass
@@ -1,5 +1,9 @@
+#include <algorithm>
 #include <array>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
 
 #include "ass/bit_span.hpp"
 #include "gtest/gtest.h"
@@ -522,4 +526,386 @@ TEST(BitSpanTest, XorAssign)
     ASSERT_EQ(a[1], 0b0110'1101);
     ASSERT_EQ(a[2], 0b1101'1011);
 }
+TEST(BitSpanTest, LargeBulkOperations)
+{
+    constexpr size_t parts_count = 40;
+    constexpr size_t size = parts_count * 32 - 5;
+    constexpr unsigned seed = 42;
+    std::mt19937 gen(seed);
+
+    std::vector<uint32_t> a(parts_count);
+    std::vector<uint32_t> b(parts_count);
+    for (size_t i = 0; i != parts_count; ++i)
+    {
+        a[i] = static_cast<uint32_t>(gen());
+        b[i] = static_cast<uint32_t>(gen());
+    }
+
+    auto reference = [&](auto op)
+    {
+        std::vector<uint32_t> r = a;
+        for (size_t i = 0; i != size; ++i)
+        {
+            const bool bit = op((a[i / 32] >> (i % 32)) & 1, (b[i / 32] >> (i % 32)) & 1) != 0;
+            r[i / 32] = (r[i / 32] & ~(uint32_t{1} << (i % 32))) | (uint32_t{bit} << (i % 32));
+        }
+        return r;
+    };
+
+    auto to_bit_span = [&](auto& parts)
+    {
+        return ToBitSpan(std::span{parts}, {.size = size});
+    };
+
+    auto apply = [&](auto op)
+    {
+        std::vector<uint32_t> r = a;
+        op(to_bit_span(r), to_bit_span(std::as_const(b)));
+        return r;
+    };
+
+    ASSERT_EQ(
+        apply(
+            [](auto x, auto y)
+            {
+                x.AndAssign(y);
+            }),
+        reference(std::bit_and<>{}));
+    ASSERT_EQ(
+        apply(
+            [](auto x, auto y)
+            {
+                x.OrAssign(y);
+            }),
+        reference(std::bit_or<>{}));
+    ASSERT_EQ(
+        apply(
+            [](auto x, auto y)
+            {
+                x.XorAssign(y);
+            }),
+        reference(std::bit_xor<>{}));
+
+    size_t expected_ones = 0;
+    for (size_t i = 0; i != size; ++i) expected_ones += (a[i / 32] >> (i % 32)) & 1;
+    ASSERT_EQ(to_bit_span(a).CountOnes(), expected_ones);
+
+    std::vector<uint32_t> flipped = a;
+    to_bit_span(flipped).Flip();
+    ASSERT_EQ(to_bit_span(flipped).CountOnes(), size - expected_ones);
+    ASSERT_EQ(flipped.back() & ~(~uint32_t{} >> 5), a.back() & ~(~uint32_t{} >> 5));
+}
+TEST(BitSpanTest, Search)
+{
+    auto check = []<typename Part>(Part, const size_t size, const double density)
+    {
+        constexpr size_t bits_per_part = sizeof(Part) * 8;
+        constexpr unsigned seed = 42;
+        std::mt19937 gen(seed);
+        std::bernoulli_distribution bit_distribution(density);
+
+        // Bits past the end of the span are set and must not be found
+        std::vector<Part> parts((size + bits_per_part - 1) / bits_per_part + 1, std::numeric_limits<Part>::max());
+        const auto bit_span = ToBitSpan(std::span{parts}, {.size = size});
+        std::vector<size_t> set_bits;
+        for (size_t i = 0; i != size; ++i)
+        {
+            const bool value = bit_distribution(gen);
+            bit_span.Set(i, value);
+            if (value) set_bits.push_back(i);
+        }
+
+        std::vector<size_t> visited;
+        bit_span.ForEachSetBit(
+            [&](const size_t index)
+            {
+                visited.push_back(index);
+            });
+        ASSERT_EQ(visited, set_bits) << "size: " << size;
+
+        for (size_t from = 0; from <= size; ++from)
+        {
+            size_t next_set = size;
+            size_t next_zero = size;
+            size_t prev_set = size;
+            for (size_t i = from; i < size; ++i)
+            {
+                if (bit_span.Get(i) && next_set == size) next_set = i;
+                if (!bit_span.Get(i) && next_zero == size) next_zero = i;
+            }
+            for (size_t i = std::min(from + 1, size); i-- != 0;)
+            {
+                if (bit_span.Get(i))
+                {
+                    prev_set = i;
+                    break;
+                }
+            }
+
+            ASSERT_EQ(bit_span.FindNextSet(from), next_set) << "size: " << size << ", from: " << from;
+            ASSERT_EQ(bit_span.FindNextZero(from), next_zero) << "size: " << size << ", from: " << from;
+            ASSERT_EQ(bit_span.FindPrevSet(from), prev_set) << "size: " << size << ", from: " << from;
+        }
+    };
+
+    for (const size_t size : {0, 1, 7, 8, 63, 64, 65, 200})
+    {
+        for (const double density : {0.0, 0.05, 0.5, 1.0})
+        {
+            check(uint8_t{}, size, density);
+            check(uint64_t{}, size, density);
+        }
+    }
+
+    constexpr auto test_constexpr = []()
+    {
+        std::array<uint16_t, 3> parts{0b1000, 0, 0b1};
+        const auto bit_span = ToBitSpan<{.size = 40}>(parts);
+        size_t count = 0;
+        bit_span.ForEachSetBit(
+            [&](size_t)
+            {
+                ++count;
+            });
+        return bit_span.FindNextSet() == 3 && bit_span.FindNextSet(4) == 32 && bit_span.FindPrevSet(31) == 3 &&
+               bit_span.FindNextZero() == 0 && count == 2;
+    };
+    static_assert(test_constexpr());
+}
+TEST(BitSpanTest, RangeOperations)
+{
+    auto check = []<typename Part>(Part, const size_t size)
+    {
+        constexpr size_t bits_per_part = sizeof(Part) * 8;
+        constexpr unsigned seed = 42;
+        constexpr size_t iterations_count = 200;
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<size_t> index_distribution(0, size);
+        std::uniform_int_distribution<int> op_distribution(0, 2);
+
+        // Bits past the end of the span must stay untouched
+        const size_t parts_count = (size + bits_per_part - 1) / bits_per_part + 1;
+        std::vector<Part> parts(parts_count, Part{0b1010});
+        const std::vector<Part> initial = parts;
+        const auto bit_span = ToBitSpan(std::span{parts}, {.size = size});
+        std::vector<bool> expected(size);
+        for (size_t i = 0; i != size; ++i) expected[i] = bit_span.Get(i);
+
+        for (size_t iteration = 0; iteration != iterations_count; ++iteration)
+        {
+            size_t begin = index_distribution(gen);
+            size_t end = index_distribution(gen);
+            if (begin > end) std::swap(begin, end);
+
+            const auto expected_ones = static_cast<size_t>(std::count(
+                expected.begin() + static_cast<ptrdiff_t>(begin),
+                expected.begin() + static_cast<ptrdiff_t>(end),
+                true));
+            ASSERT_EQ(bit_span.CountOnes(begin, end), expected_ones);
+
+            const int op = op_distribution(gen);
+            for (size_t i = begin; i != end; ++i)
+            {
+                expected[i] = op == 0 ? true : (op == 1 ? false : !expected[i]);
+            }
+
+            if (op == 0) bit_span.SetRange(begin, end);
+            if (op == 1) bit_span.ResetRange(begin, end);
+            if (op == 2) bit_span.FlipRange(begin, end);
+
+            for (size_t i = 0; i != size; ++i)
+            {
+                ASSERT_EQ(bit_span.Get(i), expected[i]) << "size: " << size << ", index: " << i;
+            }
+        }
+
+        ASSERT_EQ(parts.back(), initial.back());
+        if (const size_t used_bits = size % bits_per_part; used_bits != 0)
+        {
+            const Part unused_mask = static_cast<Part>(std::numeric_limits<Part>::max() << used_bits);
+            ASSERT_EQ(parts[parts_count - 2] & unused_mask, initial[parts_count - 2] & unused_mask);
+        }
+    };
+
+    for (const size_t size : {0, 1, 13, 64, 100, 2'000})
+    {
+        check(uint8_t{}, size);
+        check(uint64_t{}, size);
+    }
+
+    constexpr auto test_constexpr = []()
+    {
+        std::array<uint32_t, 4> parts{};
+        const auto bit_span = ToBitSpan<{.size = 120}>(parts);
+        bit_span.SetRange(10, 110);
+        bit_span.FlipRange(30, 40);
+        return bit_span.CountOnes() == 90 && bit_span.CountOnes(0, 40) == 20 && parts[3] == 0x3FFF;
+    };
+    static_assert(test_constexpr());
+}
+TEST(BitSpanTest, ShiftAndRotate)
+{
+    auto check = []<typename Part>(Part, const size_t size)
+    {
+        constexpr size_t bits_per_part = sizeof(Part) * 8;
+        constexpr unsigned seed = 42;
+        std::mt19937 gen(seed);
+        std::bernoulli_distribution bit_distribution(0.5);
+
+        // Bits past the end of the span are set and must stay untouched
+        const size_t parts_count = (size + bits_per_part - 1) / bits_per_part + 1;
+        std::vector<Part> initial(parts_count, std::numeric_limits<Part>::max());
+        std::vector<bool> bits(size);
+        {
+            const auto bit_span = ToBitSpan(std::span{initial}, {.size = size});
+            for (size_t i = 0; i != size; ++i)
+            {
+                bits[i] = bit_distribution(gen);
+                bit_span.Set(i, bits[i]);
+            }
+        }
+
+        auto check_op = [&](auto op, auto expected_bit, const size_t shift)
+        {
+            std::vector<Part> parts = initial;
+            const auto bit_span = ToBitSpan(std::span{parts}, {.size = size});
+            op(bit_span, shift);
+            for (size_t i = 0; i != size; ++i)
+            {
+                ASSERT_EQ(bit_span.Get(i), expected_bit(i, shift)) << "size: " << size << ", shift: " << shift;
+            }
+
+            ASSERT_EQ(parts.back(), initial.back());
+            if (const size_t used_bits = size % bits_per_part; used_bits != 0)
+            {
+                const Part unused_mask = static_cast<Part>(std::numeric_limits<Part>::max() << used_bits);
+                ASSERT_EQ(parts[parts_count - 2] & unused_mask, unused_mask);
+            }
+        };
+
+        for (size_t shift = 0; shift <= size + 1; ++shift)
+        {
+            check_op(
+                [](auto bit_span, size_t n)
+                {
+                    bit_span.ShiftLeft(n);
+                },
+                [&](size_t i, size_t n)
+                {
+                    return i >= n && bits[i - n];
+                },
+                shift);
+            check_op(
+                [](auto bit_span, size_t n)
+                {
+                    bit_span.ShiftRight(n);
+                },
+                [&](size_t i, size_t n)
+                {
+                    return i + n < size && bits[i + n];
+                },
+                shift);
+            check_op(
+                [](auto bit_span, size_t n)
+                {
+                    bit_span.RotateLeft(n);
+                },
+                [&](size_t i, size_t n)
+                {
+                    return bits[(i + size - n % size) % size];
+                },
+                shift);
+            check_op(
+                [](auto bit_span, size_t n)
+                {
+                    bit_span.RotateRight(n);
+                },
+                [&](size_t i, size_t n)
+                {
+                    return bits[(i + n) % size];
+                },
+                shift);
+        }
+    };
+
+    for (const size_t size : {1, 13, 64, 100, 300})
+    {
+        check(uint8_t{}, size);
+        check(uint64_t{}, size);
+    }
+
+    constexpr auto test_constexpr = []()
+    {
+        std::array<uint8_t, 2> parts{0b1000'0001, 0b1111'0000};
+        const auto bit_span = ToBitSpan<{.size = 12}>(parts);
+        bit_span.RotateRight(1);
+        const bool rotated = parts[0] == 0b0100'0000 && parts[1] == 0b1111'1000;
+        bit_span.ShiftLeft(5);
+        return rotated && parts[0] == 0 && parts[1] == 0b1111'1000;
+    };
+    static_assert(test_constexpr());
+}
+TEST(BitSpanTest, Expressions)
+{
+    constexpr size_t size = 150;
+
+    // Bits past the end of the span must stay untouched
+    std::vector<uint32_t> a(5, 0xFFFF'FFFF);
+    std::vector<uint32_t> b(5, 0);
+    std::vector<uint32_t> c(5, 0);
+    const auto span_a = ToBitSpan(std::span{a}, {.size = size});
+    const auto span_b = ToBitSpan(std::span{b}, {.size = size});
+    const auto span_c = ToBitSpan(std::span{c}, {.size = size});
+    span_b.SetRange(0, 100);
+    span_c.SetRange(140, 150);
+
+    ASSERT_EQ((Lazy(span_a) & ~Lazy(span_b)).CountOnes(), 50);
+    ASSERT_TRUE((Lazy(span_a) & span_c).Any());
+    ASSERT_FALSE((Lazy(span_b) & span_c).Any());
+
+    span_a.Assign((Lazy(span_a) & ~Lazy(span_b)) ^ span_c);
+    ASSERT_EQ(span_a.CountOnes(), 40);
+    ASSERT_EQ(span_a.FindNextSet(), 100);
+    ASSERT_EQ(span_a.FindPrevSet(), 139);
+    ASSERT_EQ(a[4] >> (size % 32), 0xFFFF'FFFF >> (size % 32));
+
+    constexpr auto test_constexpr = []()
+    {
+        std::array<uint8_t, 2> x{0b1111'0000, 0b1111'1111};
+        std::array<uint8_t, 2> y{0b1010'1010, 0b0000'0011};
+        const auto span_x = ToBitSpan<{.size = 10}>(x);
+        const auto span_y = ToBitSpan<{.size = 10}>(y);
+        span_x.Assign(Lazy(span_x) ^ span_y);
+        return x[0] == 0b0101'1010 && x[1] == 0b1111'1100 && (~Lazy(span_y)).CountOnes() == 4;
+    };
+    static_assert(test_constexpr());
+}
+TEST(BitSpanTest, Predicates)
+{
+    // Bits past the end of the span are set and must be ignored
+    std::vector<uint8_t> a(3, 0);
+    std::vector<uint8_t> b(3, 0);
+    a.back() = 0b1111'1000;
+    b.back() = 0b1111'1000;
+    const auto span_a = ToBitSpan(std::span{a}, {.size = 19});
+    const auto span_b = ToBitSpan(std::span{b}, {.size = 19});
+
+    ASSERT_TRUE(span_a.None());
+    ASSERT_FALSE(span_a.Intersects(span_b));
+    ASSERT_TRUE(span_a.IsSubsetOf(span_b));
+
+    span_a.SetRange(0, 19);
+    ASSERT_TRUE(span_a.All());
+    ASSERT_FALSE(span_a.IsSubsetOf(span_b));
+
+    span_b.Set(18, true);
+    span_b.Set(3, true);
+    ASSERT_TRUE(span_b.Any());
+    ASSERT_FALSE(span_b.All());
+    ASSERT_TRUE(span_b.IsSubsetOf(span_a));
+    ASSERT_TRUE(span_a.Intersects(span_b));
+    ASSERT_EQ(span_a.AndCount(span_b), 2);
+    ASSERT_EQ(span_a.OrCount(span_b), 19);
+    ASSERT_EQ(span_a.XorCount(span_b), 17);
+}
 }  // namespace ass
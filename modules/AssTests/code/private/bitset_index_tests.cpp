@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "ass/bitset_index.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+template <size_t kSize, typename Part>
+FixedBitset<kSize, Part> MakeRandomFingerprint(std::mt19937& gen)
+{
+    std::bernoulli_distribution distribution(0.5);
+    FixedBitset<kSize, Part> bits;
+    for (size_t index = 0; index != kSize; ++index)
+    {
+        bits.Set(index, distribution(gen));
+    }
+    return bits;
+}
+
+template <size_t kSize, typename Part>
+void CheckAgainstBruteForce(const size_t rows_count, const size_t k, const size_t threads_count)
+{
+    constexpr unsigned seed = 11;
+    std::mt19937 gen(seed);
+
+    BitsetIndex<kSize, Part> index;
+    std::vector<FixedBitset<kSize, Part>> fingerprints;
+    for (size_t row = 0; row != rows_count; ++row)
+    {
+        fingerprints.push_back(MakeRandomFingerprint<kSize, Part>(gen));
+        ASSERT_EQ(index.Add(fingerprints.back()), row);
+    }
+
+    const auto query = MakeRandomFingerprint<kSize, Part>(gen);
+    std::vector<BitsetIndexMatch> expected;
+    for (size_t row = 0; row != rows_count; ++row)
+    {
+        expected.push_back({(query ^ fingerprints[row]).CountOnes(), row});
+    }
+    std::ranges::sort(expected);
+    expected.resize(std::min(k, rows_count));
+
+    ASSERT_EQ(index.FindNearest(query, k, threads_count), expected);
+    ASSERT_EQ(index.Distance(query, rows_count / 2), (query ^ fingerprints[rows_count / 2]).CountOnes());
+}
+
+TEST(BitsetIndexTest, MatchesBruteForce)
+{
+    CheckAgainstBruteForce<256, uint64_t>(1000, 10, 1);
+    CheckAgainstBruteForce<300, uint8_t>(1000, 5, 1);
+    CheckAgainstBruteForce<1024, uint64_t>(500, 1, 1);
+    CheckAgainstBruteForce<1000, uint32_t>(100, 200, 1);
+#if ASS_HAS_UINT128
+    CheckAgainstBruteForce<300, Uint128>(1000, 5, 1);
+#endif
+}
+
+TEST(BitsetIndexTest, MultipleThreads)
+{
+    // Small distances make ties likely, which must be resolved the same way as with one thread
+    CheckAgainstBruteForce<16, uint64_t>(100'000, 50, 4);
+    CheckAgainstBruteForce<512, uint64_t>(70'000, 20, 3);
+}
+
+TEST(BitsetIndexTest, UnusedBitsAreIgnored)
+{
+    // Flip sets unused bits of the last part, they must not count as differences
+    FixedBitset<100> ones;
+    ones.Flip();
+    FixedBitset<100> filled;
+    filled.Fill(true);
+
+    BitsetIndex<100> index;
+    index.Add(filled);
+    index.Add(FixedBitset<100>{});
+    ASSERT_EQ(index.Distance(ones, 0), 0);
+    ASSERT_EQ(index.Distance(ones, 1), 100);
+
+    const auto nearest = index.FindNearest(ones, 5);
+    ASSERT_EQ(nearest, (std::vector<BitsetIndexMatch>{{0, 0}, {100, 1}}));
+    ASSERT_EQ(index.Get(0).CountOnes(), 100);
+}
+
+TEST(BitsetIndexTest, SetAndClear)
+{
+    BitsetIndex<256> index;
+    ASSERT_TRUE(index.FindNearest(FixedBitset<256>{}, 3).empty());
+
+    FixedBitset<256> a;
+    a.SetRange(0, 10);
+    index.Add(a);
+    index.Add(a);
+    ASSERT_EQ(index.GetSize(), 2);
+
+    index.Set(1, FixedBitset<256>{});
+    const auto nearest = index.FindNearest(FixedBitset<256>{}, 1);
+    ASSERT_EQ(nearest, (std::vector<BitsetIndexMatch>{{0, 1}}));
+    ASSERT_TRUE(index.FindNearest(a, 0).empty());
+
+    index.Clear();
+    ASSERT_TRUE(index.IsEmpty());
+}
+}  // namespace ass
@@ -0,0 +1,187 @@
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+
+#include "ass/bounded_fixed_unordered_map.hpp"
+#include "gtest/gtest.h"
+
+namespace bounded_fixed_unordered_map_tests
+{
+struct CollisionsHasher
+{
+    constexpr size_t operator()(const int) const noexcept
+    {
+        return 3;
+    }
+};
+
+struct ModuloHasher
+{
+    constexpr size_t operator()(const int v) const noexcept
+    {
+        return static_cast<size_t>(v % 7);
+    }
+};
+
+TEST(BoundedFixedUnorderedMapTest, OverflowGoesToStash)
+{
+    ass::BoundedFixedUnorderedMap<16, int, int, CollisionsHasher, 2, 4> map;
+    static_assert(decltype(map)::kMaxProbesPerOperation == 6);
+
+    for (int i = 0; i != 6; ++i)
+    {
+        ASSERT_NE(map.TryAdd(i, i * 10), nullptr);
+    }
+
+    ASSERT_EQ(map.Size(), 6);
+    ASSERT_EQ(map.StashSize(), 4);
+
+    // Main table has free slots but none of them is within the probe window
+    ASSERT_EQ(map.TryAdd(6, 60), nullptr);
+
+    for (int i = 0; i != 6; ++i)
+    {
+        ASSERT_TRUE(map.Contains(i));
+        ASSERT_EQ(map.Get(i), i * 10);
+    }
+
+    // Free a slot in the window: stashed keys must still be reachable and not duplicated
+    ASSERT_EQ(map.Remove(0), 0);
+    ASSERT_EQ(map.StashSize(), 4);
+    ASSERT_EQ(*map.TryAdd(5, 55), 55);
+    ASSERT_EQ(map.Size(), 5);
+    ASSERT_EQ(map.StashSize(), 4);
+
+    ASSERT_NE(map.TryAdd(6, 60), nullptr);
+    ASSERT_EQ(map.StashSize(), 4);
+    ASSERT_EQ(map.Size(), 6);
+
+    size_t visited = 0;
+    for (auto kv : map)
+    {
+        ASSERT_EQ(map.Get(kv.key), kv.value);
+        ++visited;
+    }
+    ASSERT_EQ(visited, 6);
+}
+
+TEST(BoundedFixedUnorderedMapTest, FullWidthStash)
+{
+    ass::BoundedFixedUnorderedMap<4, int, int, CollisionsHasher, 1, 64> map;
+    for (int i = 0; i != 65; ++i)
+    {
+        ASSERT_NE(map.TryAdd(i, i), nullptr);
+    }
+    ASSERT_EQ(map.StashSize(), 64);
+    ASSERT_EQ(map.TryAdd(65, 65), nullptr);
+
+    // Freed stash slot is reused and keys stay unique
+    ASSERT_EQ(map.Remove(40), 40);
+    ASSERT_EQ(map.StashSize(), 63);
+    ASSERT_EQ(*map.TryAdd(64, 640), 640);
+    ASSERT_EQ(map.Size(), 64);
+    ASSERT_NE(map.TryAdd(65, 65), nullptr);
+    ASSERT_EQ(map.StashSize(), 64);
+    ASSERT_FALSE(map.Contains(40));
+    ASSERT_EQ(map.Get(64), 640);
+    ASSERT_EQ(map.Get(65), 65);
+}
+
+TEST(BoundedFixedUnorderedMapTest, WideKeysInStash)
+{
+    struct Hasher
+    {
+        constexpr size_t operator()(const uint64_t) const noexcept
+        {
+            return 0;
+        }
+    };
+
+    // Odd stash size leaves a tail that is not compared with vector instructions
+    ass::BoundedFixedUnorderedMap<4, uint64_t, int, Hasher, 1, 5> map;
+    constexpr uint64_t kHigh = uint64_t{1} << 32;
+    for (int i = 0; i != 6; ++i)
+    {
+        ASSERT_NE(map.TryAdd(kHigh * static_cast<uint64_t>(i) + 7, i), nullptr);
+    }
+    ASSERT_EQ(map.StashSize(), 5);
+
+    // Keys that differ only in one half must not match
+    ASSERT_FALSE(map.Contains(7 + 1));
+    ASSERT_FALSE(map.Contains(kHigh * 3));
+    for (int i = 0; i != 6; ++i)
+    {
+        ASSERT_EQ(map.Get(kHigh * static_cast<uint64_t>(i) + 7), i);
+    }
+}
+
+TEST(BoundedFixedUnorderedMapTest, MatchesStdMap)
+{
+    auto check = []<bool cached_size>(std::bool_constant<cached_size>)
+    {
+        constexpr unsigned seed = 42;
+        constexpr size_t iterations_count = 20'000;
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> key_distribution(0, 60);
+        std::bernoulli_distribution remove_distribution(0.4);
+
+        ass::BoundedFixedUnorderedMap<32, int, int, ModuloHasher, 3, 8, ass::LinearProbing, cached_size> map;
+        std::unordered_map<int, int> expected;
+
+        for (size_t iteration = 0; iteration != iterations_count; ++iteration)
+        {
+            const int key = key_distribution(gen);
+            if (remove_distribution(gen))
+            {
+                const auto removed = map.Remove(key);
+                ASSERT_EQ(removed.has_value(), expected.erase(key) != 0);
+            }
+            else if (int* value = map.TryAdd(key, static_cast<int>(iteration)))
+            {
+                ASSERT_EQ(*value, static_cast<int>(iteration));
+                expected[key] = *value;
+            }
+            else
+            {
+                // Refused insert must not drop existing key
+                ASSERT_FALSE(expected.contains(key));
+            }
+
+            ASSERT_EQ(map.Size(), expected.size()) << "iteration: " << iteration;
+        }
+
+        for (int key = 0; key != 61; ++key)
+        {
+            const int* value = map.Find(key);
+            auto it = expected.find(key);
+            ASSERT_EQ(value != nullptr, it != expected.end());
+            if (value)
+            {
+                ASSERT_EQ(*value, it->second);
+            }
+        }
+    };
+
+    check(std::false_type{});
+    check(std::true_type{});
+}
+
+static constexpr bool ConstexprTest()
+{
+    ass::BoundedFixedUnorderedMap<8, int, int, CollisionsHasher, 1, 2> map{};
+    map.Add(1, 10);
+    map.Add(2, 20);
+    map.Add(3, 30);
+
+    if (map.TryAdd(4, 40) != nullptr) return false;
+    if (map.StashSize() != 2) return false;
+    if (map.Get(3) != 30) return false;
+    if (map.Remove(1) != 10) return false;
+    if (map.Contains(1)) return false;
+
+    return map.TryAdd(4, 40) != nullptr && map.Size() == 3;
+}
+
+static_assert(ConstexprTest());
+}  // namespace bounded_fixed_unordered_map_tests
@@ -0,0 +1,127 @@
+#include <bitset>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "ass/bit_span.hpp"
+#include "ass/counted_bits.hpp"
+#include "ass/fixed_bitset.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+// Applies random operations and checks the cached count against the real one after every step
+template <size_t size, typename Bits>
+void CheckCountedBits(CountedBits<Bits>& bits)
+{
+    constexpr unsigned seed = 42;
+    constexpr size_t iterations_count = 2'000;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> index_distribution(0, size - 1);
+    std::uniform_int_distribution<int> op_distribution(0, 9);
+
+    using Part = std::remove_cvref_t<decltype(bits.GetBits().GetPart(0))>;
+    FixedBitset<size, Part> other;
+    for (size_t i = 0; i != size / 3; ++i) other.Set(index_distribution(gen), true);
+
+    for (size_t iteration = 0; iteration != iterations_count; ++iteration)
+    {
+        size_t begin = index_distribution(gen);
+        size_t end = index_distribution(gen);
+        if (begin > end) std::swap(begin, end);
+
+        switch (op_distribution(gen))
+        {
+        case 0:
+        case 1:
+        case 2:
+            bits.Set(begin, !bits.Get(begin));
+            break;
+        case 3:
+            bits.SetRange(begin, end);
+            break;
+        case 4:
+            bits.ResetRange(begin, end);
+            break;
+        case 5:
+            bits.FlipRange(begin, end);
+            break;
+        case 6:
+            bits.Flip();
+            break;
+        case 7:
+            bits.ShiftLeft(begin % 70);
+            break;
+        case 8:
+            bits.ShiftRight(begin % 70);
+            break;
+        default:
+            bits = Lazy(bits) ^ other;
+            break;
+        }
+
+        ASSERT_EQ(bits.CountOnes(), bits.GetBits().CountOnes()) << "iteration: " << iteration;
+        ASSERT_EQ(bits.Any(), bits.GetBits().Any());
+        ASSERT_EQ(bits.All(), bits.GetBits().All());
+        ASSERT_EQ(bits.OrCount(other), bits.GetBits().OrCount(other));
+        ASSERT_EQ(bits.XorCount(other), bits.GetBits().XorCount(other));
+    }
+
+    bits.Fill(true);
+    ASSERT_TRUE(bits.All());
+    ASSERT_EQ(bits.CountOnes(), size);
+    bits.Fill(false);
+    ASSERT_TRUE(bits.None());
+}
+
+TEST(CountedBitsTest, FixedBitset)
+{
+    CountedBits<FixedBitset<300>> bits;
+    ASSERT_EQ(bits.CountOnes(), 0);
+    ASSERT_TRUE(bits.Set(5, true));
+    ASSERT_FALSE(bits.Set(5, true));
+    ASSERT_EQ(bits.CountOnes(), 1);
+    CheckCountedBits<300>(bits);
+}
+
+TEST(CountedBitsTest, BitSpan)
+{
+    // Bits past the size belong to somebody else and must survive all operations
+    std::vector<uint64_t> parts(5, 0);
+    parts.back() = ~uint64_t{0} << 44;
+    auto span = ToBitSpan(std::span{parts}, {.size = 300});
+    span.SetRange(10, 20);
+
+    CountedBits bits(span);
+    ASSERT_EQ(bits.CountOnes(), 10);
+    CheckCountedBits<300>(bits);
+    ASSERT_EQ(parts.back(), ~uint64_t{0} << 44);
+}
+
+#if ASS_HAS_UINT128
+TEST(CountedBitsTest, Uint128Parts)
+{
+    FixedBitset<256, Uint128> a;
+    FixedBitset<256, Uint128> b;
+    a.SetRange(0, 100);
+    b.SetRange(50, 200);
+
+    CountedBits<FixedBitset<256, Uint128>> bits;
+    bits = Lazy(a) | Lazy(b);
+    ASSERT_EQ(bits.CountOnes(), 200);
+    CheckCountedBits<256>(bits);
+}
+#endif
+
+static constexpr bool CountedBitsConstexprTest()
+{
+    CountedBits<FixedBitset<100>> a;
+    a.SetRange(0, 50);
+    a.Set(70, true);
+    a.ShiftLeft(40);
+    CountedBits<FixedBitset<100>> b = ~Lazy(a);
+    return a.CountOnes() == 50 && b.CountOnes() == 50 && !a.Intersects(b);
+}
+
+static_assert(CountedBitsConstexprTest());
+}  // namespace ass
@@ -0,0 +1,160 @@
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "ass/dynamic_bitset.hpp"
+#include "ass/parallel_bit_span.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+TEST(DynamicBitsetTest, InlineAndHeap)
+{
+    DynamicBitset<uint64_t, 2> bits(100);
+    ASSERT_TRUE(bits.IsInline());
+    ASSERT_EQ(bits.GetSize(), 100);
+    ASSERT_TRUE(bits.None());
+
+    bits.Set(3, true);
+    bits.Set(99, true);
+    bits.Resize(1000);
+    ASSERT_FALSE(bits.IsInline());
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(bits.GetParts().data()) % dynamic_bitset_detail::kHeapAlignment, 0);
+    ASSERT_EQ(bits.CountOnes(), 2);
+    ASSERT_TRUE(bits.Get(3));
+    ASSERT_TRUE(bits.Get(99));
+
+    bits.Resize(50);
+    bits.ShrinkToFit();
+    ASSERT_TRUE(bits.IsInline());
+    ASSERT_EQ(bits.CountOnes(), 1);
+
+    // Bits dropped by shrinking do not come back
+    bits.Resize(128);
+    ASSERT_EQ(bits.CountOnes(), 1);
+    ASSERT_FALSE(bits.Get(99));
+}
+
+TEST(DynamicBitsetTest, ResizeWithValue)
+{
+    DynamicBitset<uint8_t, 1> bits(5, true);
+    ASSERT_EQ(bits.CountOnes(), 5);
+
+    bits.Resize(300, true);
+    ASSERT_TRUE(bits.All());
+    bits.Resize(7);
+    bits.Resize(20, false);
+    ASSERT_EQ(bits.CountOnes(), 7);
+    ASSERT_EQ(bits.GetParts()[0], 0x7F);
+    ASSERT_EQ(bits.GetParts()[1], 0);
+}
+
+TEST(DynamicBitsetTest, PushBackMatchesVectorBool)
+{
+    constexpr unsigned seed = 5;
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution distribution(0.3);
+
+    DynamicBitset<uint32_t> bits;
+    std::vector<bool> expected;
+    for (size_t index = 0; index != 10'000; ++index)
+    {
+        const bool value = distribution(gen);
+        bits.PushBack(value);
+        expected.push_back(value);
+    }
+
+    ASSERT_EQ(bits.GetSize(), expected.size());
+    ASSERT_GE(bits.GetCapacity(), bits.GetSize());
+    for (size_t index = 0; index != expected.size(); ++index)
+    {
+        ASSERT_EQ(bits.Get(index), expected[index]) << index;
+    }
+}
+
+TEST(DynamicBitsetTest, CopyAndMove)
+{
+    DynamicBitset<> large(1000);
+    large.Set(500, true);
+    DynamicBitset<> small(10);
+    small.Set(1, true);
+
+    DynamicBitset<> copy = large;
+    ASSERT_EQ(copy, large);
+    copy = small;
+    ASSERT_EQ(copy, small);
+    copy.Resize(1000);
+    ASSERT_FALSE(copy.Get(500));
+
+    const auto* large_parts = large.GetParts().data();
+    DynamicBitset<> moved = std::move(large);
+    ASSERT_EQ(moved.GetParts().data(), large_parts);
+    ASSERT_TRUE(moved.Get(500));
+    ASSERT_TRUE(large.IsEmpty());  // NOLINT
+    ASSERT_TRUE(large.IsInline());
+
+    DynamicBitset<> moved_small = std::move(small);
+    ASSERT_TRUE(moved_small.Get(1));
+    small.Resize(10);  // NOLINT
+    ASSERT_TRUE(small.None());
+
+    moved = std::move(moved_small);
+    ASSERT_TRUE(moved.IsInline());
+    ASSERT_EQ(moved.GetSize(), 10);
+}
+
+TEST(DynamicBitsetTest, SpanOperations)
+{
+    DynamicBitset<> a(10'000);
+    DynamicBitset<> b(10'000);
+    a.GetSpan().SetRange(0, 6000);
+    b.GetSpan().SetRange(4000, 10'000);
+
+    ASSERT_EQ(a.GetSpan().AndCount(b.GetSpan()), 2000);
+
+    auto a_span = a.GetSpan();
+    a_span.XorAssign(b.GetSpan());
+    ASSERT_EQ(a.CountOnes(), 8000);
+
+    a = Lazy(a) & ~Lazy(b);
+    ASSERT_EQ(a.CountOnes(), 4000);
+    ASSERT_EQ(ParallelCountOnes(a.GetSpan(), 4), 4000);
+
+    // Flip must not set bits past the size
+    DynamicBitset<> c(70);
+    c.GetSpan().Flip();
+    c.Resize(128);
+    ASSERT_EQ(c.CountOnes(), 70);
+}
+
+#if ASS_HAS_UINT128
+TEST(DynamicBitsetTest, Uint128Parts)
+{
+    DynamicBitset<Uint128, 1> bits(100);
+    bits.GetSpan().SetRange(20, 90);
+    bits.Resize(100'000);
+    ASSERT_FALSE(bits.IsInline());
+    bits.GetSpan().SetRange(70'000, 70'050);
+    ASSERT_EQ(bits.CountOnes(), 120);
+    ASSERT_EQ(ParallelCountOnes(bits.GetSpan(), 4), 120);
+    ASSERT_EQ(bits.GetSpan().FindNextSet(90), 70'000);
+
+    DynamicBitset<Uint128, 1> other(100'000);
+    other.GetSpan().SetRange(0, 50);
+    ParallelXorAssign(bits.GetSpan(), other.GetSpan(), 3);
+    ASSERT_EQ(bits.CountOnes(), 120 - 30 + 20);
+
+    std::atomic<size_t> visited = 0;
+    ParallelForEachSetBit(
+        bits.GetSpan(),
+        [&](size_t)
+        {
+            visited.fetch_add(1, std::memory_order_relaxed);
+        },
+        2);
+    ASSERT_EQ(visited.load(), 110);
+}
+#endif
+}  // namespace ass
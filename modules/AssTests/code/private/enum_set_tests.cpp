@@ -31,6 +31,18 @@ enum class MyEnum
 
 DEFINE_CONTINUOUS_ENUM_INDEX_CONVERTER(ass::enum_set_tests::MyEnum, A);
 
+namespace ass::enum_set_tests
+{
+// Needs several bitset parts
+enum class WideEnum : uint8_t
+{
+    kFirst = 0,
+    kMax = 200
+};
+}  // namespace ass::enum_set_tests
+
+DEFINE_CONTINUOUS_ENUM_INDEX_CONVERTER(ass::enum_set_tests::WideEnum, kFirst);
+
 namespace ass::enum_set_tests
 {
 TEST(EnumSetTests, AddRemove)
@@ -274,4 +286,86 @@ TEST(EnumSetTests, AddRemoveWithCustomRange)
     ASSERT_EQ(s.GetComplement().Size(), s.Capacity());
 }
 
+TEST(EnumSetTests, Expressions)
+{
+    const auto a = MakeEnumSet(MyEnum::A, MyEnum::B, MyEnum::C);
+    const auto b = MakeEnumSet(MyEnum::B, MyEnum::D);
+    const auto c = MakeEnumSet(MyEnum::G);
+
+    const EnumSet<MyEnum> r = (Lazy(a) & ~Lazy(b)) | c;
+    ASSERT_EQ(r.Size(), 3);
+    ASSERT_TRUE(r.Contains(MyEnum::A));
+    ASSERT_TRUE(r.Contains(MyEnum::C));
+    ASSERT_TRUE(r.Contains(MyEnum::G));
+
+    // Complement must not count unused bits of the bitset
+    ASSERT_EQ((~Lazy(a)).CountOnes(), 4);
+    ASSERT_EQ((Lazy(a) ^ b).CountOnes(), 3);
+    ASSERT_TRUE((Lazy(a) & b).Any());
+    ASSERT_FALSE((Lazy(a) & c).Any());
+
+    // Operators on sets return values
+    ASSERT_EQ((~a).Size(), 4);
+    ASSERT_EQ((a ^ b).Size(), 3);
+    ASSERT_EQ((a | c).Size(), 4);
+
+    EnumSet<MyEnum> s = a;
+    s = s & b;
+    ASSERT_EQ(s.Size(), 1);
+    ASSERT_TRUE(s.Contains(MyEnum::B));
+
+    ASSERT_EQ((a - b).Size(), 2);
+    ASSERT_EQ(a.GetIntersectionWith(b).Size(), 1);
+}
+
+TEST(EnumSetTests, Predicates)
+{
+    const auto a = MakeEnumSet(MyEnum::A, MyEnum::B);
+    const auto b = MakeEnumSet(MyEnum::A, MyEnum::B, MyEnum::C);
+    const auto c = MakeEnumSet(MyEnum::G);
+
+    ASSERT_TRUE(a.IsSubsetOf(b));
+    ASSERT_FALSE(b.IsSubsetOf(a));
+    ASSERT_TRUE(a.Intersects(b));
+    ASSERT_FALSE(a.Intersects(c));
+    ASSERT_EQ(a.IntersectionSize(b), 2);
+    ASSERT_EQ(a.UnionSize(c), 3);
+    ASSERT_EQ(b.SymmetricDifferenceSize(c), 4);
+    ASSERT_FALSE(b.IsFull());
+    ASSERT_TRUE(EnumSet<MyEnum>::Full().IsFull());
+    ASSERT_TRUE(MakeEnumSet<MyEnum>().IsEmpty());
+}
+
+
+TEST(EnumSetTests, WideEnumSize)
+{
+    auto check = []<bool cached_size>(std::bool_constant<cached_size>)
+    {
+        using Set = EnumSet<WideEnum, EnumIndexConverter<WideEnum>, cached_size>;
+        Set a;
+        for (int value = 0; value < 200; value += 3)
+        {
+            a.Add(static_cast<WideEnum>(value));
+        }
+        ASSERT_EQ(a.Size(), 67);
+        ASSERT_FALSE(a.Add(WideEnum::kFirst));
+        ASSERT_TRUE(a.Remove(WideEnum::kFirst));
+        ASSERT_EQ(a.Size(), 66);
+
+        Set b = ~a;
+        ASSERT_EQ(b.Size(), 134);
+        a.Invert();
+        ASSERT_EQ(a.Size(), 134);
+        ASSERT_EQ(Set::Full().Size(), 200);
+        ASSERT_TRUE(Set::Full().IsFull());
+        ASSERT_EQ(a.GetBitset().CountOnes(), 134);
+    };
+
+    check(std::false_type{});
+    check(std::true_type{});
+
+    // The counter is opt-in and does not change the default layout
+    static_assert(sizeof(EnumSet<WideEnum>) == sizeof(EnumSet<WideEnum>{}.GetBitset()));
+    static_assert(sizeof(EnumSet<WideEnum, EnumIndexConverter<WideEnum>, true>) > sizeof(EnumSet<WideEnum>));
+}
 }  // namespace ass::enum_set_tests
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ass/ewah_bitmap.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+// Alternating runs of zeros and ones of random length with some noise between them
+std::vector<uint64_t> MakeRunsParts(const size_t size, const unsigned seed)
+{
+    std::mt19937_64 gen(seed);
+    std::vector<uint64_t> parts((size + 63) / 64);
+    const auto bits = ToBitSpan(std::span{parts}, {.size = size});
+    bool value = false;
+    for (size_t begin = 0; begin < size;)
+    {
+        const size_t end = std::min(size, begin + gen() % 5000);
+        if (value) bits.SetRange(begin, end);
+        for (size_t noise = gen() % 4; noise != 0 && end != size; --noise)
+        {
+            bits.Set(begin + gen() % (end - begin + 1), gen() % 2 != 0);
+        }
+        value = !value;
+        begin = end;
+    }
+    return parts;
+}
+
+EwahBitmap Encode(const std::vector<uint64_t>& parts, const size_t size, const size_t chunk_size)
+{
+    EwahBitmap bitmap;
+    for (size_t begin = 0; begin < size; begin += chunk_size)
+    {
+        const size_t chunk_parts_count = (std::min(chunk_size, size - begin) + 63) / 64;
+        const auto chunk = BitSpan<const uint64_t>(
+            parts.data() + begin / 64,
+            {.parts_count = chunk_parts_count, .size = std::min(chunk_size, size - begin)});
+        bitmap.Append(chunk);
+    }
+    return bitmap;
+}
+
+std::vector<uint64_t> Decode(const EwahBitmap& bitmap, const size_t chunk_size)
+{
+    const size_t size = bitmap.GetSize();
+    std::vector<uint64_t> parts((size + 63) / 64);
+    EwahReader reader = bitmap.GetReader();
+    for (size_t begin = 0; begin < size; begin += chunk_size)
+    {
+        const size_t chunk_parts_count = (std::min(chunk_size, size - begin) + 63) / 64;
+        reader.Read(BitSpan<uint64_t>(
+            parts.data() + begin / 64,
+            {.parts_count = chunk_parts_count, .size = std::min(chunk_size, size - begin)}));
+    }
+    EXPECT_TRUE(reader.IsDone());
+    return parts;
+}
+
+TEST(EwahBitmapTest, MarkerPacking)
+{
+    constexpr ewah_bitmap_detail::Marker marker{
+        .run_bit = true,
+        .run_length = ewah_bitmap_detail::kMaxRunLength,
+        .literals_count = 12345};
+    constexpr auto unpacked = ewah_bitmap_detail::UnpackMarker(ewah_bitmap_detail::PackMarker(marker));
+    static_assert(unpacked.run_bit && unpacked.run_length == marker.run_length && unpacked.literals_count == 12345);
+}
+
+TEST(EwahBitmapTest, RoundTrip)
+{
+    constexpr size_t size = 1'000'037;
+    const auto parts = MakeRunsParts(size, 1);
+    const auto span = ToBitSpan(std::span{parts}, {.size = size});
+    for (const size_t chunk_size : {size_t{64}, size_t{4096}, size_t{640'000}, size})
+    {
+        const EwahBitmap bitmap = Encode(parts, size, chunk_size);
+        ASSERT_EQ(bitmap.GetSize(), size);
+        ASSERT_EQ(bitmap.CountOnes(), span.CountOnes());
+        ASSERT_LT(bitmap.GetSizeInBytes(), parts.size() * sizeof(uint64_t) / 4);
+        for (const size_t decode_chunk_size : {size_t{128}, size_t{65536}, size})
+        {
+            ASSERT_EQ(Decode(bitmap, decode_chunk_size), parts);
+        }
+    }
+}
+
+TEST(EwahBitmapTest, RandomBitsCostLittle)
+{
+    constexpr size_t size = 100'032;
+    std::mt19937_64 gen(2);
+    std::vector<uint64_t> parts((size + 63) / 64);
+    for (uint64_t& part : parts) part = gen() & ((uint64_t{1} << 63) - 1);
+
+    const EwahBitmap bitmap = Encode(parts, size, 6400);
+    ASSERT_EQ(bitmap.GetWords().size(), parts.size() + 1);
+    ASSERT_EQ(Decode(bitmap, size), parts);
+}
+
+TEST(EwahBitmapTest, Fill)
+{
+    // Runs longer than a single marker can hold are split
+    constexpr size_t run_words_count = ewah_bitmap_detail::kMaxRunLength + 5;
+    EwahBitmap bitmap;
+    bitmap.AppendFill(true, run_words_count * 64);
+    bitmap.AppendFill(false, 64 * 3);
+    bitmap.AppendFill(true, 10);
+    ASSERT_EQ(bitmap.GetSize(), (run_words_count + 3) * 64 + 10);
+    ASSERT_EQ(bitmap.CountOnes(), run_words_count * 64 + 10);
+    ASSERT_EQ(bitmap.GetWords().size(), 4);
+
+    EwahReader reader = bitmap.GetReader();
+    reader.Skip(run_words_count + 2);
+    std::vector<uint64_t> tail(4, 0xFF00);
+    ASSERT_EQ(reader.ReadWords(tail), 2);
+    ASSERT_EQ(tail, (std::vector<uint64_t>{0, 0x3FF, 0xFF00, 0xFF00}));
+    ASSERT_TRUE(reader.IsDone());
+}
+
+TEST(EwahBitmapTest, DecodeKeepsBitsPastChunk)
+{
+    std::vector<uint64_t> parts{0x0123'4567'89AB'CDEF};
+    const EwahBitmap bitmap = Encode(parts, 20, 20);
+
+    std::vector<uint64_t> out{~uint64_t{0}};
+    bitmap.GetReader().Read(ToBitSpan(std::span{out}, {.size = 20}));
+    ASSERT_EQ(out[0], ~uint64_t{0xFFFFF} | 0xBCDEF);
+}
+
+TEST(EwahBitmapTest, FromWords)
+{
+    // Whole words, so the stream can be extended
+    constexpr size_t size = 320'000;
+    const auto parts = MakeRunsParts(size, 3);
+    const EwahBitmap bitmap = Encode(parts, size, 100'032);
+
+    const auto words = bitmap.GetWords();
+    auto opt_loaded = EwahBitmap::FromWords({words.begin(), words.end()}, size);
+    ASSERT_TRUE(opt_loaded.has_value());
+    EwahBitmap& loaded = *opt_loaded;
+    ASSERT_EQ(Decode(loaded, 64 * 78), parts);
+
+    // Appending continues the stream
+    loaded.AppendFill(false, 960);
+    loaded.AppendFill(true, 64);
+    ASSERT_EQ(loaded.GetSize(), size + 1024);
+    ASSERT_EQ(loaded.CountOnes(), bitmap.CountOnes() + 64);
+}
+
+TEST(EwahBitmapTest, FromCorruptedWords)
+{
+    using ewah_bitmap_detail::PackMarker;
+
+    // A run of ones and two literals: 136 bits, the last literal uses 8 bits
+    constexpr size_t size = 136;
+    const std::vector<uint64_t> words{PackMarker({.run_bit = true, .run_length = 1, .literals_count = 2}), 0x1234, 0x56};
+    const auto loaded = EwahBitmap::FromWords(words, size);
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(loaded->CountOnes(), 64 + 5 + 4);
+
+    // Marker promises more literals than there are left
+    const std::vector<uint64_t> truncated(words.begin(), words.end() - 1);
+    ASSERT_FALSE(EwahBitmap::FromWords(truncated, size).has_value());
+
+    std::vector<uint64_t> overlong = words;
+    overlong[0] = PackMarker({.run_bit = true, .run_length = 1, .literals_count = ewah_bitmap_detail::kMaxLiteralsCount});
+    ASSERT_FALSE(EwahBitmap::FromWords(overlong, size).has_value());
+
+    for (const auto& corrupted : {truncated, overlong})
+    {
+        EwahReader reader(corrupted);
+        std::vector<uint64_t> out(4);
+        ASSERT_EQ(reader.ReadWords(out), 0);
+        ASSERT_TRUE(reader.IsDone());
+        ASSERT_TRUE(reader.IsCorrupted());
+    }
+    ASSERT_FALSE(EwahReader(words).IsCorrupted());
+
+    // Words decode to more or fewer words than the size needs
+    ASSERT_FALSE(EwahBitmap::FromWords(words, size + 64).has_value());
+    ASSERT_FALSE(EwahBitmap::FromWords(words, size - 64).has_value());
+    std::vector<uint64_t> extra = words;
+    extra.push_back(PackMarker({.run_bit = false, .run_length = 1, .literals_count = 0}));
+    ASSERT_FALSE(EwahBitmap::FromWords(extra, size).has_value());
+
+    // Bits past the size are set
+    std::vector<uint64_t> dirty_tail = words;
+    dirty_tail.back() |= uint64_t{1} << 8;
+    ASSERT_FALSE(EwahBitmap::FromWords(dirty_tail, size).has_value());
+}
+
+TEST(EwahBitmapTest, LogicalOperations)
+{
+    constexpr size_t size = 777'777;
+    const auto a_parts = MakeRunsParts(size, 4);
+    const auto b_parts = MakeRunsParts(size, 5);
+    const EwahBitmap a = Encode(a_parts, size, 64 * 1000);
+    const EwahBitmap b = Encode(b_parts, size, size);
+
+    auto check = [&](const EwahBitmap& actual, auto op)
+    {
+        std::vector<uint64_t> expected(a_parts.size());
+        for (size_t i = 0; i != expected.size(); ++i) expected[i] = op(a_parts[i], b_parts[i]);
+        return actual.GetSize() == size && Decode(actual, 64 * 333) == expected;
+    };
+
+    ASSERT_TRUE(check(a & b, std::bit_and{}));
+    ASSERT_TRUE(check(a | b, std::bit_or{}));
+    ASSERT_TRUE(check(a ^ b, std::bit_xor{}));
+    ASSERT_EQ((a ^ a).CountOnes(), 0);
+    ASSERT_EQ((a ^ a).GetWords().size(), 1);
+    ASSERT_EQ(Decode(a & a, size), a_parts);
+
+    // Operands made of long runs stay compressed
+    EwahBitmap x;
+    x.AppendFill(true, 64 * 1'000'000);
+    x.AppendFill(false, 64 * 1'000'000);
+    EwahBitmap y;
+    y.AppendFill(false, 64 * 500'000);
+    y.AppendFill(true, 64 * 1'500'000);
+    ASSERT_EQ((x & y).CountOnes(), 64 * 500'000);
+    ASSERT_EQ((x | y).CountOnes(), 64 * 2'000'000);
+    ASSERT_EQ((x ^ y).CountOnes(), 64 * 1'500'000);
+    ASSERT_LE((x ^ y).GetWords().size(), 3);
+}
+}  // namespace ass
@@ -1,6 +1,11 @@
+#include <array>
 #include <bitset>
+#include <concepts>
 #include <random>
+#include <utility>
+#include <vector>
 
+#include "ass/bit_span.hpp"
 #include "ass/fixed_bitset.hpp"
 #include "gtest/gtest.h"
 
@@ -166,4 +171,567 @@ TEST(FixedBitsetTest, Flip)
     check_with_capacity(std::integral_constant<size_t, 16>{});
     check_with_capacity(std::integral_constant<size_t, 17>{});
 }
+
+TEST(FixedBitsetTest, LargeBulkOperations)
+{
+    // Big enough to go through SIMD kernels
+    constexpr size_t capacity = 1'000;
+    constexpr unsigned seed = 42;
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution bit_distribution(0.5);
+
+    FixedBitset<capacity> fa;
+    FixedBitset<capacity> fb;
+    std::bitset<capacity> sa;
+    std::bitset<capacity> sb;
+    for (size_t i = 0; i != capacity; ++i)
+    {
+        const bool a = bit_distribution(gen);
+        const bool b = bit_distribution(gen);
+        fa.Set(i, a);
+        sa.set(i, a);
+        fb.Set(i, b);
+        sb.set(i, b);
+    }
+
+    auto same = [&](const FixedBitset<capacity>& f, const std::bitset<capacity>& s)
+    {
+        for (size_t i = 0; i != capacity; ++i)
+        {
+            if (f.Get(i) != s[i]) return false;
+        }
+        return f.CountOnes() == s.count();
+    };
+
+    ASSERT_TRUE(same(fa, sa));
+    ASSERT_TRUE(same(fa & fb, sa & sb));
+    ASSERT_TRUE(same(fa | fb, sa | sb));
+    ASSERT_TRUE(same(~fa, ~sa));
+}
+
+static constexpr bool LargeBitsetConstexprTest()
+{
+    FixedBitset<1'000> a;
+    FixedBitset<1'000> b;
+    for (size_t i = 0; i < 1'000; i += 3) a.Set(i, true);
+    for (size_t i = 0; i < 1'000; i += 2) b.Set(i, true);
+
+    const bool and_ok = (a & b).CountOnes() == 167;
+    const bool or_ok = (a | b).CountOnes() == 334 + 500 - 167;
+    const bool not_ok = (~a).CountOnes() == 1'000 - 334;
+    return and_ok && or_ok && not_ok;
+}
+
+static_assert(LargeBitsetConstexprTest());
+TEST(FixedBitsetTest, Search)
+{
+    auto check_with_capacity = []<size_t capacity>(std::integral_constant<size_t, capacity>)
+    {
+        constexpr unsigned seed = 42;
+        std::mt19937 gen(seed);
+
+        for (const double density : {0.0, 0.01, 0.5, 0.99, 1.0})
+        {
+            std::bernoulli_distribution bit_distribution(density);
+            FixedBitset<capacity> fbs;
+            std::vector<size_t> set_bits;
+            for (size_t i = 0; i != capacity; ++i)
+            {
+                if (bit_distribution(gen))
+                {
+                    fbs.Set(i, true);
+                    set_bits.push_back(i);
+                }
+            }
+
+            // Same bits but unused bits of the last part are set and must not be found
+            FixedBitset<capacity> noisy;
+            noisy.Fill(true);
+            for (size_t i = 0; i != capacity; ++i)
+            {
+                noisy.Set(i, fbs.Get(i));
+            }
+
+            std::vector<size_t> visited;
+            noisy.ForEachSetBit(
+                [&](const size_t index)
+                {
+                    visited.push_back(index);
+                });
+            ASSERT_EQ(visited, set_bits) << "capacity: " << capacity;
+
+            for (size_t from = 0; from <= capacity; ++from)
+            {
+                size_t next_set = capacity;
+                size_t next_zero = capacity;
+                size_t prev_set = capacity;
+                for (size_t i = from; i < capacity; ++i)
+                {
+                    if (fbs.Get(i) && next_set == capacity) next_set = i;
+                    if (!fbs.Get(i) && next_zero == capacity) next_zero = i;
+                }
+                for (size_t i = std::min(from + 1, capacity); i-- != 0;)
+                {
+                    if (fbs.Get(i))
+                    {
+                        prev_set = i;
+                        break;
+                    }
+                }
+
+                ASSERT_EQ(fbs.FindNextSet(from), next_set) << "capacity: " << capacity << ", from: " << from;
+                ASSERT_EQ(fbs.FindNextZero(from), next_zero) << "capacity: " << capacity << ", from: " << from;
+                ASSERT_EQ(fbs.FindPrevSet(from), prev_set) << "capacity: " << capacity << ", from: " << from;
+                ASSERT_EQ(noisy.FindNextSet(from), next_set) << "capacity: " << capacity << ", from: " << from;
+                ASSERT_EQ(noisy.FindPrevSet(from), prev_set) << "capacity: " << capacity << ", from: " << from;
+            }
+        }
+    };
+
+    check_with_capacity(std::integral_constant<size_t, 1>{});
+    check_with_capacity(std::integral_constant<size_t, 13>{});
+    check_with_capacity(std::integral_constant<size_t, 64>{});
+    check_with_capacity(std::integral_constant<size_t, 65>{});
+    check_with_capacity(std::integral_constant<size_t, 300>{});
+}
+
+static constexpr bool SearchConstexprTest()
+{
+    FixedBitset<200> fbs;
+    fbs.Set(3, true);
+    fbs.Set(130, true);
+
+    size_t sum = 0;
+    fbs.ForEachSetBit(
+        [&](const size_t index)
+        {
+            sum += index;
+        });
+
+    return fbs.FindNextSet() == 3 && fbs.FindNextSet(4) == 130 && fbs.FindNextSet(131) == 200 &&
+           fbs.FindPrevSet() == 130 && fbs.FindPrevSet(129) == 3 && fbs.FindPrevSet(2) == 200 &&
+           fbs.FindNextZero(3) == 4 && sum == 133;
+}
+
+static_assert(SearchConstexprTest());
+TEST(FixedBitsetTest, RangeOperations)
+{
+    constexpr size_t capacity = 3'000;
+    constexpr unsigned seed = 42;
+    constexpr size_t iterations_count = 500;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> index_distribution(0, capacity);
+    std::uniform_int_distribution<int> op_distribution(0, 2);
+
+    FixedBitset<capacity> fbs;
+    std::bitset<capacity> sbs;
+    for (size_t iteration = 0; iteration != iterations_count; ++iteration)
+    {
+        size_t begin = index_distribution(gen);
+        size_t end = index_distribution(gen);
+        if (begin > end) std::swap(begin, end);
+
+        size_t expected_ones = 0;
+        for (size_t i = begin; i != end; ++i) expected_ones += sbs[i];
+        ASSERT_EQ(fbs.CountOnes(begin, end), expected_ones) << "iteration: " << iteration;
+
+        const int op = op_distribution(gen);
+        for (size_t i = begin; i != end; ++i)
+        {
+            sbs[i] = op == 0 ? true : (op == 1 ? false : !sbs[i]);
+        }
+
+        if (op == 0) fbs.SetRange(begin, end);
+        if (op == 1) fbs.ResetRange(begin, end);
+        if (op == 2) fbs.FlipRange(begin, end);
+
+        ASSERT_EQ(fbs.CountOnes(), sbs.count()) << "iteration: " << iteration;
+        for (size_t i = 0; i != capacity; ++i)
+        {
+            ASSERT_EQ(fbs.Get(i), sbs[i]) << "iteration: " << iteration << ", index: " << i;
+        }
+    }
+}
+
+static constexpr bool RangeConstexprTest()
+{
+    FixedBitset<100> fbs;
+    fbs.SetRange(5, 95);
+    fbs.ResetRange(10, 20);
+    fbs.FlipRange(0, 8);
+    return fbs.CountOnes() == 82 && fbs.CountOnes(0, 10) == 7 && fbs.CountOnes(10, 20) == 0 &&
+           fbs.CountOnes(20, 100) == 75 && fbs.CountOnes(50, 50) == 0;
+}
+
+static_assert(RangeConstexprTest());
+TEST(FixedBitsetTest, ShiftAndRotate)
+{
+    auto check_with_capacity = []<size_t capacity>(std::integral_constant<size_t, capacity>)
+    {
+        constexpr unsigned seed = 42;
+        std::mt19937 gen(seed);
+        std::bernoulli_distribution bit_distribution(0.5);
+
+        FixedBitset<capacity> fbs;
+        std::bitset<capacity> sbs;
+        for (size_t i = 0; i != capacity; ++i)
+        {
+            const bool value = bit_distribution(gen);
+            fbs.Set(i, value);
+            sbs.set(i, value);
+        }
+
+        // Garbage in unused bits must not be shifted in
+        fbs.Flip();
+        fbs.Flip();
+
+        auto same = [&](const FixedBitset<capacity>& f, const std::bitset<capacity>& b)
+        {
+            for (size_t i = 0; i != capacity; ++i)
+            {
+                if (f.Get(i) != b[i]) return false;
+            }
+            return f.CountOnes() == b.count();
+        };
+
+        for (size_t shift = 0; shift <= capacity + 1; ++shift)
+        {
+            ASSERT_TRUE(same(fbs << shift, sbs << shift)) << "capacity: " << capacity << ", shift: " << shift;
+            ASSERT_TRUE(same(fbs >> shift, sbs >> shift)) << "capacity: " << capacity << ", shift: " << shift;
+
+            const size_t r = shift % capacity;
+            const std::bitset<capacity> rotated_left = (sbs << r) | (sbs >> ((capacity - r) % capacity));
+            const std::bitset<capacity> rotated_right = (sbs >> r) | (sbs << ((capacity - r) % capacity));
+            ASSERT_TRUE(same(FixedBitset<capacity>{fbs}.RotateLeft(shift), rotated_left)) << "shift: " << shift;
+            ASSERT_TRUE(same(FixedBitset<capacity>{fbs}.RotateRight(shift), rotated_right)) << "shift: " << shift;
+        }
+    };
+
+    check_with_capacity(std::integral_constant<size_t, 1>{});
+    check_with_capacity(std::integral_constant<size_t, 13>{});
+    check_with_capacity(std::integral_constant<size_t, 64>{});
+    check_with_capacity(std::integral_constant<size_t, 100>{});
+    check_with_capacity(std::integral_constant<size_t, 256>{});
+    check_with_capacity(std::integral_constant<size_t, 1'000>{});
+}
+
+static constexpr bool ShiftConstexprTest()
+{
+    FixedBitset<100> fbs;
+    fbs.Set(0, true);
+    fbs.Set(99, true);
+
+    const auto shifted = fbs << 70;
+    auto rotated = fbs;
+    rotated.RotateLeft(1);
+    return shifted.FindNextSet() == 70 && shifted.CountOnes() == 1 && (fbs >> 99).FindNextSet() == 0 &&
+           rotated.FindNextSet() == 0 && rotated.FindNextSet(1) == 1 && rotated.CountOnes() == 2;
+}
+
+static_assert(ShiftConstexprTest());
+TEST(FixedBitsetTest, Expressions)
+{
+    auto check_with_capacity = []<size_t capacity>(std::integral_constant<size_t, capacity>)
+    {
+        constexpr unsigned seed = 42;
+        std::mt19937 gen(seed);
+        std::bernoulli_distribution bit_distribution(0.5);
+
+        FixedBitset<capacity> fa, fb, fc;
+        std::bitset<capacity> sa, sb, sc;
+        for (size_t i = 0; i != capacity; ++i)
+        {
+            fa.Set(i, bit_distribution(gen));
+            fb.Set(i, bit_distribution(gen));
+            fc.Set(i, bit_distribution(gen));
+            sa.set(i, fa.Get(i));
+            sb.set(i, fb.Get(i));
+            sc.set(i, fc.Get(i));
+        }
+
+        auto same = [&](const FixedBitset<capacity>& f, const std::bitset<capacity>& s)
+        {
+            for (size_t i = 0; i != capacity; ++i)
+            {
+                if (f.Get(i) != s[i]) return false;
+            }
+            return f.CountOnes() == s.count();
+        };
+
+        ASSERT_TRUE(same((Lazy(fa) & ~Lazy(fb)) | fc, (sa & ~sb) | sc));
+        ASSERT_TRUE(same(~(Lazy(fa) ^ fb) & ~Lazy(fc), ~(sa ^ sb) & ~sc));
+        ASSERT_EQ(((Lazy(fa) & ~Lazy(fb)) | fc).CountOnes(), ((sa & ~sb) | sc).count());
+        ASSERT_EQ((~Lazy(fa)).CountOnes(), capacity - sa.count());
+        ASSERT_EQ((Lazy(fa) ^ fb).Any(), (sa ^ sb).any());
+        ASSERT_FALSE((Lazy(fa) & ~Lazy(fa)).Any());
+
+        // Eager operators give the same result
+        ASSERT_TRUE(same((fa & ~fb) | fc, (sa & ~sb) | sc));
+
+        // Expression may refer to the bitset it is assigned to
+        FixedBitset<capacity> fr = fa;
+        fr = Lazy(fb) & ~Lazy(fr);
+        ASSERT_TRUE(same(fr, sb & ~sa));
+
+        fr |= Lazy(fa) ^ fc;
+        ASSERT_TRUE(same(fr, (sb & ~sa) | (sa ^ sc)));
+        fr &= ~fc;
+        ASSERT_TRUE(same(fr, ((sb & ~sa) | (sa ^ sc)) & ~sc));
+        fr ^= fa;
+        ASSERT_TRUE(same(fr, (((sb & ~sa) | (sa ^ sc)) & ~sc) ^ sa));
+    };
+
+    check_with_capacity(std::integral_constant<size_t, 13>{});
+    check_with_capacity(std::integral_constant<size_t, 64>{});
+    check_with_capacity(std::integral_constant<size_t, 1'000>{});
+}
+
+template <typename Left, typename Right>
+concept can_combine_lazily = requires(Left&& left, Right&& right) { std::forward<Left>(left) & std::forward<Right>(right); };
+
+TEST(FixedBitsetTest, OperatorsReturnValues)
+{
+    FixedBitset<100> a;
+    FixedBitset<100> b;
+    a.Set(1, true);
+    b.Set(1, true);
+
+    // Operators on containers make independent copies
+    auto c = ~a;
+    auto d = a | b;
+    static_assert(std::same_as<decltype(c), FixedBitset<100>>);
+    static_assert(std::same_as<decltype(d), FixedBitset<100>>);
+    a.Set(2, true);
+    ASSERT_TRUE(c.Get(2));
+    ASSERT_FALSE(d.Get(2));
+
+    // Lazy expression is a view on its operands
+    auto e = Lazy(a) & ~Lazy(b);
+    static_assert(bit_expression<decltype(e)>);
+    ASSERT_EQ(e.CountOnes(), 1);
+    a.Set(3, true);
+    ASSERT_EQ(e.CountOnes(), 2);
+
+    // Temporary containers can not become operands of a lazy expression
+    using Expression = decltype(Lazy(a));
+    static_assert(can_combine_lazily<Expression, FixedBitset<100>&>);
+    static_assert(!can_combine_lazily<Expression, FixedBitset<100>>);
+    static_assert(!can_combine_lazily<FixedBitset<100>&, BitSpan<uint8_t>&>);
+}
+
+TEST(FixedBitsetTest, ExpressionsWithBitSpans)
+{
+    constexpr size_t capacity = 200;
+    FixedBitset<capacity> fbs;
+    fbs.SetRange(0, 100);
+
+    std::array<uint64_t, 4> parts{};
+    const auto bit_span = ToBitSpan<{.size = capacity}>(parts);
+    bit_span.SetRange(50, 150);
+
+    const FixedBitset<capacity> r = Lazy(fbs) ^ bit_span;
+    ASSERT_EQ(r.CountOnes(), 100);
+    ASSERT_EQ(r.FindNextSet(), 0);
+    ASSERT_EQ(r.FindNextSet(50), 100);
+
+    bit_span.Assign(Lazy(bit_span) & ~Lazy(fbs));
+    ASSERT_EQ(bit_span.CountOnes(), 50);
+    ASSERT_EQ(bit_span.FindNextSet(), 100);
+}
+
+static constexpr bool ExpressionsConstexprTest()
+{
+    FixedBitset<100> a;
+    FixedBitset<100> b;
+    FixedBitset<100> c;
+    a.SetRange(0, 60);
+    b.SetRange(40, 100);
+    c.SetRange(90, 100);
+
+    const FixedBitset<100> r = (a & ~b) | c;
+    return r.CountOnes() == 50 && ((a & ~b) | c).CountOnes() == 50 && (a ^ b).CountOnes() == 80 &&
+           (~a).CountOnes() == 40 && !(a & ~a).Any();
+}
+
+static_assert(ExpressionsConstexprTest());
+TEST(FixedBitsetTest, Predicates)
+{
+    constexpr size_t capacity = 1'000;
+    constexpr unsigned seed = 42;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> index_distribution(0, capacity - 1);
+
+    for (size_t iteration = 0; iteration != 100; ++iteration)
+    {
+        FixedBitset<capacity> fa;
+        FixedBitset<capacity> fb;
+        std::bitset<capacity> sa;
+        std::bitset<capacity> sb;
+        for (size_t i = 0; i != iteration % 10; ++i)
+        {
+            const size_t a = index_distribution(gen);
+            const size_t b = index_distribution(gen);
+            fa.Set(a, true);
+            sa.set(a);
+            fb.Set(b, true);
+            sb.set(b);
+        }
+
+        if (iteration % 3 == 0)
+        {
+            fb |= fa;
+            sb |= sa;
+        }
+
+        ASSERT_EQ(fa.Any(), sa.any());
+        ASSERT_EQ(fa.None(), sa.none());
+        ASSERT_EQ(fa.Intersects(fb), (sa & sb).any());
+        ASSERT_EQ(fa.IsSubsetOf(fb), (sa & ~sb).none());
+        ASSERT_EQ(fa.AndCount(fb), (sa & sb).count());
+        ASSERT_EQ(fa.OrCount(fb), (sa | sb).count());
+        ASSERT_EQ(fa.XorCount(fb), (sa ^ sb).count());
+    }
+
+    // Unused bits must not affect predicates
+    FixedBitset<13> full;
+    full.Fill(true);
+    ASSERT_TRUE(full.All());
+    full.Set(12, false);
+    ASSERT_FALSE(full.All());
+    full.Fill(false);
+    full.Flip();
+    full.ResetRange(0, 13);
+    ASSERT_TRUE(full.None());
+}
+
+static constexpr bool PredicatesConstexprTest()
+{
+    FixedBitset<300> a;
+    FixedBitset<300> b;
+    a.SetRange(10, 20);
+    b.SetRange(0, 100);
+    return a.IsSubsetOf(b) && !b.IsSubsetOf(a) && a.Intersects(b) && a.AndCount(b) == 10 && a.OrCount(b) == 100 &&
+           a.XorCount(b) == 90 && !a.All() && (a | ~a).All() && a.IsSubsetOf(a & b);
+}
+
+static_assert(PredicatesConstexprTest());
+
+static_assert(std::same_as<FixedBitset<12>::Part, uint16_t>);
+static_assert(std::same_as<FixedBitset<12, uint64_t>::Part, uint64_t>);
+static_assert(FixedBitset<12, uint64_t>::kPartsCount == 1);
+static_assert(FixedBitset<200, uint8_t>::kPartsCount == 25);
+
+template <size_t size, typename Part>
+void CheckExplicitPart()
+{
+    constexpr unsigned seed = 42;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> index_distribution(0, size - 1);
+
+    FixedBitset<size, Part> fbs;
+    std::bitset<size> sbs;
+    fbs.Flip();
+    fbs.Flip();
+    for (size_t iteration = 0; iteration != 200; ++iteration)
+    {
+        const size_t index = index_distribution(gen);
+        fbs.Set(index, !sbs[index]);
+        sbs.flip(index);
+
+        const size_t from = index_distribution(gen);
+        ASSERT_EQ(fbs.CountOnes(), sbs.count());
+        ASSERT_EQ(fbs.CountOnes(0, from), (sbs << (size - from)).count());
+        ASSERT_EQ((~fbs).CountOnes(), size - sbs.count());
+
+        size_t expected_next = from;
+        while (expected_next != size && !sbs[expected_next]) ++expected_next;
+        ASSERT_EQ(fbs.FindNextSet(from), expected_next);
+
+        size_t expected_prev = size;
+        for (size_t i = from + 1; i-- != 0;)
+        {
+            if (sbs[i])
+            {
+                expected_prev = i;
+                break;
+            }
+        }
+        ASSERT_EQ(fbs.FindPrevSet(from), expected_prev);
+
+        FixedBitset<size, Part> shifted = fbs;
+        shifted <<= from;
+        FixedBitset<size, Part> rotated = fbs;
+        rotated.RotateLeft(from);
+        const std::bitset<size> expected_rotated = (sbs << from) | (sbs >> (size - from));
+        for (size_t i = 0; i != size; ++i)
+        {
+            ASSERT_EQ(shifted.Get(i), (sbs << from)[i]);
+            ASSERT_EQ(rotated.Get(i), expected_rotated[i]);
+        }
+
+        // Rotated copy serves as a mask: extracted bits go to the bottom and deposit puts them back
+        const FixedBitset<size, Part> extracted = fbs.ExtractBits(rotated);
+        size_t extracted_count = 0;
+        for (size_t i = 0; i != size; ++i)
+        {
+            if (expected_rotated[i])
+            {
+                ASSERT_EQ(extracted.Get(extracted_count++), sbs[i]);
+            }
+        }
+        ASSERT_EQ(extracted.FindNextSet(extracted_count), size);
+        ASSERT_TRUE((extracted.DepositBits(rotated) ^ (fbs & rotated)).None());
+    }
+
+    // BitSpan over the same memory sees the same bits and writes through
+    auto span = ToBitSpan<{.size = size}>(fbs.GetParts());
+    using ExpectedSpan = BitSpan<Part, BitSpanStaticExtents{.parts_count = fbs.kPartsCount, .size = size}>;
+    static_assert(std::same_as<decltype(span), ExpectedSpan>);
+    ASSERT_EQ(span.CountOnes(), sbs.count());
+    span.Set(size - 1, !sbs[size - 1]);
+    ASSERT_EQ(fbs.Get(size - 1), !sbs[size - 1]);
+}
+
+TEST(FixedBitsetTest, ExplicitPart)
+{
+    CheckExplicitPart<12, uint8_t>();
+    CheckExplicitPart<12, uint64_t>();
+    CheckExplicitPart<200, uint8_t>();
+    CheckExplicitPart<200, uint16_t>();
+    CheckExplicitPart<200, uint32_t>();
+    CheckExplicitPart<1000, uint16_t>();
+#if ASS_HAS_UINT128
+    CheckExplicitPart<12, Uint128>();
+    CheckExplicitPart<200, Uint128>();
+    CheckExplicitPart<1000, Uint128>();
+#endif
+}
+
+static constexpr bool ExplicitPartConstexprTest()
+{
+    FixedBitset<70, uint8_t> a;
+    a.SetRange(3, 67);
+    a >>= 2;
+    return a.CountOnes() == 64 && a.FindNextSet() == 1 && a.FindPrevSet() == 64 && a.GetParts().size() == 9;
+}
+
+static_assert(ExplicitPartConstexprTest());
+
+#if ASS_HAS_UINT128
+static_assert(bit_part<Uint128> && bit_part<const Uint128>);
+static_assert(std::same_as<BitsCountToUnsignedIntT<128>, Uint128>);
+static_assert(FixedBitset<200, Uint128>::kPartsCount == 2);
+
+static constexpr bool Uint128PartConstexprTest()
+{
+    FixedBitset<300, Uint128> a;
+    a.SetRange(100, 140);
+    a.Set(299, true);
+    a.RotateLeft(30);
+    return a.CountOnes() == 41 && a.FindNextSet() == 29 && a.FindNextSet(30) == 130 && a.FindPrevSet() == 169 &&
+           a.FindPrevSet(128) == 29 && bit_part_detail::CountLeftZero(a.GetPart(1)) == 128 - 42;
+}
+
+static_assert(Uint128PartConstexprTest());
+#endif
 }  // namespace ass
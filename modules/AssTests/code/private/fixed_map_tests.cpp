@@ -104,20 +104,65 @@ public:
             result += "_collisions";
         }
 
+        if constexpr (std::is_same_v<ass::QuadraticProbing, typename T::ProbePolicy>)
+        {
+            result += "_quadratic";
+        }
+        else if constexpr (std::is_same_v<ass::DoubleHashing, typename T::ProbePolicy>)
+        {
+            result += "_double";
+        }
+
+        if constexpr (T::kCachedSize)
+        {
+            result += "_cached_size";
+        }
+
         return result;
     }
 };
 
-template <typename Capacity, typename Key, typename Value, typename Hasher>
-using MapAlias = ass::FixedUnorderedMap<Capacity::kValue, Key, Value, Hasher>;
+template <typename Capacity, typename Key, typename Value, typename Hasher, typename ProbePolicy>
+using MapAlias = ass::FixedUnorderedMap<Capacity::kValue, Key, Value, Hasher, ProbePolicy>;
 
 using test_helpers::TypedConstant;
-using Implementations = test_helpers::GParametrizeWithCombinations<
+using LinearProbingImplementations = test_helpers::ParametrizeWithCombinations<
     MapAlias,
     /*Capacity*/ std::tuple<TypedConstant<10>, TypedConstant<20>, TypedConstant<100>>,
     /* Keys */ std::tuple<int, NonTrivialInteger<int>>,
     /* Values */ std::tuple<int, NonTrivialInteger<int>>,
-    /*Hashers*/ std::tuple<ConstexprHasher, ConstexprHasherCollisions>>;
+    /*Hashers*/ std::tuple<ConstexprHasher, ConstexprHasherCollisions>,
+    /*Probe policies*/ std::tuple<ass::LinearProbing>>;
+
+// Quadratic probing needs power of two capacity
+using OtherProbingImplementations = test_helpers::ParametrizeWithCombinations<
+    MapAlias,
+    /*Capacity*/ std::tuple<TypedConstant<16>, TypedConstant<64>>,
+    /* Keys */ std::tuple<int, NonTrivialInteger<int>>,
+    /* Values */ std::tuple<int>,
+    /*Hashers*/ std::tuple<ConstexprHasher, ConstexprHasherCollisions>,
+    /*Probe policies*/ std::tuple<ass::QuadraticProbing, ass::DoubleHashing>>;
+
+template <typename Capacity, typename Key, typename Value, typename Hasher, typename ProbePolicy>
+using CachedSizeMapAlias = ass::FixedUnorderedMap<Capacity::kValue, Key, Value, Hasher, ProbePolicy, true>;
+
+using CachedSizeImplementations = test_helpers::ParametrizeWithCombinations<
+    CachedSizeMapAlias,
+    /*Capacity*/ std::tuple<TypedConstant<20>, TypedConstant<100>>,
+    /* Keys */ std::tuple<int, NonTrivialInteger<int>>,
+    /* Values */ std::tuple<int>,
+    /*Hashers*/ std::tuple<ConstexprHasher, ConstexprHasherCollisions>,
+    /*Probe policies*/ std::tuple<ass::LinearProbing>>;
+
+// Cached size is opt-in and must not change the default layout
+static_assert(
+    sizeof(ass::FixedUnorderedMap<100, int, int, ConstexprHasher>) <
+    sizeof(ass::FixedUnorderedMap<100, int, int, ConstexprHasher, ass::LinearProbing, true>));
+
+using Implementations = test_helpers::TupleToGoogleTestTypes<decltype(std::tuple_cat(
+    LinearProbingImplementations{},
+    OtherProbingImplementations{},
+    CachedSizeImplementations{}))>;
 
 TYPED_TEST_SUITE(FixedUnorderedMapTest, Implementations, FixedUnorderedMapTestNames);
 
@@ -436,8 +481,234 @@ static constexpr bool ConstexprIteratorTest()
     return true;
 }
 
+TYPED_TEST(FixedUnorderedMapTest, EraseIf)
+{
+    using Self = typename std::decay_t<decltype(*this)>;
+    using Map = typename Self::MapType;
+    using Key = typename Map::Key;
+    using Value = typename Map::Value;
+    auto make_key = MakeKeyMaker<Key>();
+    auto make_value = MakeValueMaker<Value>();
+    constexpr size_t Capacity = Map::Capacity();
+
+    Map map{};
+    for (size_t i = 0; i != Capacity; ++i)
+    {
+        map.Add(make_key(i), make_value(i));
+    }
+
+    const size_t removed = map.EraseIf(
+        [&](const Key& key, const Value&)
+        {
+            for (size_t i = 0; i < Capacity; i += 3)
+            {
+                if (key == make_key(i)) return true;
+            }
+            return false;
+        });
+
+    ASSERT_EQ(removed, (Capacity + 2) / 3);
+    ASSERT_EQ(map.Size(), Capacity - removed);
+    for (size_t i = 0; i != Capacity; ++i)
+    {
+        const auto* value = map.Find(make_key(i));
+        if (i % 3 == 0)
+        {
+            ASSERT_EQ(value, nullptr);
+        }
+        else
+        {
+            ASSERT_NE(value, nullptr);
+            ASSERT_EQ(*value, make_value(i));
+        }
+    }
+
+    // Removed keys can be added back
+    for (size_t i = 0; i < Capacity; i += 3)
+    {
+        ASSERT_NE(map.TryAdd(make_key(i), make_value(i)), nullptr);
+    }
+    ASSERT_EQ(map.Size(), Capacity);
+}
+
+TEST(FixedUnorderedMapBulkTest, DropTombstonesShortensProbes)
+{
+    ass::FixedUnorderedMap<16, int, int, ConstexprHasherCollisions> m;
+    for (int i = 0; i != 16; ++i)
+    {
+        m.Add(i, i);
+    }
+
+    for (int i = 0; i != 15; ++i)
+    {
+        m.Remove(i);
+    }
+
+    ASSERT_EQ(m.CountProbes(15), 16);
+    ASSERT_EQ(m.CountProbes(100), 16);
+    m.DropTombstones();
+    ASSERT_EQ(m.CountProbes(15), 1);
+    ASSERT_EQ(m.CountProbes(100), 2);
+    ASSERT_EQ(m.Get(15), 15);
+    ASSERT_EQ(m.Size(), 1);
+}
+
+TEST(FixedUnorderedMapBulkTest, EraseIfDropsTombstonesPastThreshold)
+{
+    using Map = ass::FixedUnorderedMap<16, int, int, ConstexprHasherCollisions>;
+    Map m;
+    for (int i = 0; i != 16; ++i)
+    {
+        m.Add(i, i);
+    }
+
+    // Exactly a quarter of the slots become tombstones and stay in place
+    static_assert(Map::kTombstonesDropFraction == 4);
+    const size_t few_removed = m.EraseIf(
+        [](const int key, int&)
+        {
+            return key < 4;
+        });
+    ASSERT_EQ(few_removed, 4);
+    ASSERT_EQ(m.CountProbes(15), 16);
+
+    // More tombstones cross the threshold
+    const size_t many_removed = m.EraseIf(
+        [](const int key, int&)
+        {
+            return key < 14;
+        });
+    ASSERT_EQ(many_removed, 10);
+    ASSERT_EQ(m.CountProbes(15), 2);
+    ASSERT_EQ(m.Get(14), 14);
+    ASSERT_EQ(m.Get(15), 15);
+    ASSERT_EQ(m.Size(), 2);
+}
+
+TEST(FixedUnorderedMapBulkTest, SetAlgebra)
+{
+    using Map = ass::FixedUnorderedMap<32, int, int, ConstexprHasher>;
+    Map a;
+    Map b;
+    for (int i = 0; i != 10; ++i)
+    {
+        a.Add(i, i);
+        b.Add(i + 5, 100 * i);
+    }
+
+    Map intersection = a;
+    ASSERT_EQ(intersection.IntersectWith(b), 5);
+    ASSERT_EQ(intersection.Size(), 5);
+    for (int i = 5; i != 10; ++i)
+    {
+        ASSERT_EQ(intersection.Get(i), i);
+    }
+
+    Map difference = a;
+    ASSERT_EQ(difference.Subtract(b), 5);
+    for (int i = 0; i != 5; ++i)
+    {
+        ASSERT_EQ(difference.Get(i), i);
+    }
+
+    Map sum = a;
+    ASSERT_TRUE(sum.MergeFrom(
+        b,
+        [](int& value, const int another_value)
+        {
+            value += another_value;
+        }));
+    ASSERT_EQ(sum.Size(), 15);
+    ASSERT_EQ(sum.Get(0), 0);
+    ASSERT_EQ(sum.Get(7), 7 + 200);
+    ASSERT_EQ(sum.Get(14), 900);
+
+    Map overwritten = a;
+    ASSERT_TRUE(overwritten.MergeFrom(b));
+    ASSERT_EQ(overwritten.Get(7), 200);
+
+    ass::FixedUnorderedMap<4, int, int, ConstexprHasher> small;
+    ASSERT_FALSE(small.MergeFrom(a));
+    ASSERT_EQ(small.Size(), 4);
+}
+
+TEST(FixedUnorderedMapRegressionTest, ReAddAfterRemovingCollidingKey)
+{
+    ass::FixedUnorderedMap<8, int, int, ConstexprHasherCollisions> m;
+    m.Add(1, 10);
+    m.Add(2, 20);
+    ASSERT_EQ(m.Remove(1), 10);
+
+    // Key 2 is stored after the deleted slot and must be updated in place
+    m.Add(2, 21);
+    ASSERT_EQ(m.Size(), 1);
+    ASSERT_EQ(m.Get(2), 21);
+    ASSERT_EQ(m.Remove(2), 21);
+    ASSERT_FALSE(m.Contains(2));
+}
+
+TEST(FixedUnorderedMapRegressionTest, EmplaceStoresKey)
+{
+    ass::FixedUnorderedMap<8, int, int, ConstexprHasher> m;
+    m.Emplace(5, 50);
+    ASSERT_TRUE(m.Contains(5));
+    ASSERT_EQ(m.Get(5), 50);
+    m.Emplace(5, 51);
+    ASSERT_EQ(m.Size(), 1);
+    ASSERT_EQ(m.Get(5), 51);
+}
+
+template <typename ProbePolicy>
+static constexpr bool ConstexprProbePolicyTest()
+{
+    constexpr size_t Capacity = 16;
+    ass::FixedUnorderedMap<Capacity, int, int, ConstexprHasherCollisions, ProbePolicy> m{};
+
+    auto make_key = MakeKeyMaker<int>();
+    auto make_value = MakeValueMaker<int>();
+
+    for (size_t i = 0; i != Capacity; ++i)
+    {
+        m.Add(make_key(i), make_value(i));
+    }
+
+    if (m.TryAdd(make_key(Capacity)) != nullptr) return false;
+
+    for (size_t i = 0; i != Capacity; ++i)
+    {
+        if (m.Get(make_key(i)) != make_value(i)) return false;
+
+        // Every key has the same hash so i-th key is found after exactly i + 1 probes
+        if (m.CountProbes(make_key(i)) != i + 1) return false;
+    }
+
+    return true;
+}
+
+static constexpr bool ConstexprBulkTest()
+{
+    ass::FixedUnorderedMap<10, int, int, ConstexprHasherCollisions> m{};
+    for (int i = 0; i != 10; ++i)
+    {
+        m.Add(i, i * i);
+    }
+
+    const size_t removed = m.EraseIf(
+        [](const int key, int& value)
+        {
+            value += 1;
+            return key % 2 == 0;
+        });
+
+    return removed == 5 && m.Size() == 5 && m.Get(3) == 10 && !m.Contains(4);
+}
+
 static_assert(ConstexprTest());
 static_assert(ConstexprIteratorTest());
+static_assert(ConstexprBulkTest());
+static_assert(ConstexprProbePolicyTest<ass::LinearProbing>());
+static_assert(ConstexprProbePolicyTest<ass::QuadraticProbing>());
+static_assert(ConstexprProbePolicyTest<ass::DoubleHashing>());
 
 // TEST(FixedUnorderedMapConstexpr, Iterator)
 // {
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "ass/fixed_unordered_multi_map.hpp"
+#include "gtest/gtest.h"
+
+namespace fixed_unordered_multi_map_tests
+{
+struct ConstexprHasher
+{
+    constexpr size_t operator()(const int v) const noexcept
+    {
+        return static_cast<size_t>(v);
+    }
+};
+
+template <typename Range>
+std::vector<int> ToVector(const Range& range)
+{
+    std::vector<int> result;
+    for (const int& value : range)
+    {
+        result.push_back(value);
+    }
+    return result;
+}
+
+TEST(FixedUnorderedMultiMapTest, EqualRange)
+{
+    ass::FixedUnorderedMultiMap<8, int, int, ConstexprHasher> map;
+    map.Add(1, 10);
+    map.Add(2, 20);
+    map.Add(1, 11);
+    map.Add(1, 12);
+
+    ASSERT_EQ(map.Size(), 4);
+    ASSERT_EQ(map.KeysCount(), 2);
+    ASSERT_EQ(map.Count(1), 3);
+    ASSERT_EQ(map.Count(2), 1);
+    ASSERT_EQ(map.Count(3), 0);
+    ASSERT_EQ(ToVector(map.EqualRange(1)), (std::vector<int>{10, 11, 12}));
+    ASSERT_EQ(ToVector(map.EqualRange(2)), (std::vector<int>{20}));
+    ASSERT_TRUE(map.EqualRange(3).IsEmpty());
+
+    for (int& value : map.EqualRange(1))
+    {
+        value *= 2;
+    }
+    ASSERT_EQ(ToVector(std::as_const(map).EqualRange(1)), (std::vector<int>{20, 22, 24}));
+
+    ASSERT_EQ(map.Remove(1), 3);
+    ASSERT_FALSE(map.Contains(1));
+    ASSERT_EQ(map.Size(), 1);
+}
+
+TEST(FixedUnorderedMultiMapTest, CollidingKeys)
+{
+    struct CollisionsHasher
+    {
+        constexpr size_t operator()(const int) const noexcept
+        {
+            return 0;
+        }
+    };
+
+    ass::FixedUnorderedMultiMap<8, int, int, CollisionsHasher> map;
+    map.Add(1, 10);
+    map.Add(2, 20);
+    map.Add(3, 30);
+    ASSERT_EQ(map.Remove(1), 1);
+
+    // Key 2 is stored after the deleted key slot, new value must go to the existing chain
+    map.Add(2, 21);
+    ASSERT_EQ(map.KeysCount(), 2);
+    ASSERT_EQ(ToVector(map.EqualRange(2)), (std::vector<int>{20, 21}));
+    ASSERT_EQ(ToVector(map.EqualRange(3)), (std::vector<int>{30}));
+}
+
+TEST(FixedUnorderedMultiMapTest, Full)
+{
+    ass::FixedUnorderedMultiMap<4, int, int, ConstexprHasher> map;
+    ASSERT_NE(map.TryAdd(1, 1), nullptr);
+    ASSERT_NE(map.TryAdd(1, 2), nullptr);
+    ASSERT_NE(map.TryAdd(2, 3), nullptr);
+    ASSERT_NE(map.TryAdd(3, 4), nullptr);
+    ASSERT_EQ(map.TryAdd(1, 5), nullptr);
+    ASSERT_EQ(map.TryAdd(4, 5), nullptr);
+
+    // Released slots are reused
+    ASSERT_EQ(map.RemoveIf(
+                  1,
+                  [](const int v)
+                  {
+                      return v == 1;
+                  }),
+              1);
+    ASSERT_NE(map.TryAdd(4, 5), nullptr);
+    ASSERT_EQ(ToVector(map.EqualRange(1)), (std::vector<int>{2}));
+    ASSERT_EQ(ToVector(map.EqualRange(4)), (std::vector<int>{5}));
+}
+
+TEST(FixedUnorderedMultiMapTest, MatchesStdMultiMap)
+{
+    constexpr unsigned seed = 42;
+    constexpr size_t iterations_count = 10'000;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> key_distribution(0, 15);
+    std::uniform_int_distribution<int> action_distribution(0, 9);
+
+    ass::FixedUnorderedMultiMap<64, int, int, ConstexprHasher> map;
+    std::map<int, std::vector<int>> expected;
+    size_t expected_size = 0;
+
+    for (size_t iteration = 0; iteration != iterations_count; ++iteration)
+    {
+        const int key = key_distribution(gen);
+        const int value = static_cast<int>(iteration);
+        const int action = action_distribution(gen);
+        if (action == 0)
+        {
+            ASSERT_EQ(map.Remove(key), expected[key].size());
+            expected_size -= expected[key].size();
+            expected[key].clear();
+        }
+        else if (action < 3)
+        {
+            auto is_odd = [](const int v)
+            {
+                return v % 2 != 0;
+            };
+            const size_t removed = map.RemoveIf(key, is_odd);
+            ASSERT_EQ(removed, std::erase_if(expected[key], is_odd));
+            expected_size -= removed;
+        }
+        else if (map.TryAdd(key, value))
+        {
+            expected[key].push_back(value);
+            ++expected_size;
+        }
+        else
+        {
+            ASSERT_EQ(expected_size, map.Capacity());
+        }
+
+        ASSERT_EQ(map.Size(), expected_size);
+        ASSERT_EQ(ToVector(map.EqualRange(key)), expected[key]) << "iteration: " << iteration;
+    }
+}
+
+static constexpr bool ConstexprTest()
+{
+    ass::FixedUnorderedMultiMap<8, int, int, ConstexprHasher> map{};
+    map.Add(5, 1);
+    map.Add(5, 2);
+    map.Add(6, 3);
+
+    int sum = 0;
+    for (const int v : map.EqualRange(5)) sum += v;
+
+    return sum == 3 && map.Remove(5) == 2 && map.Size() == 1;
+}
+
+static_assert(ConstexprTest());
+}  // namespace fixed_unordered_multi_map_tests
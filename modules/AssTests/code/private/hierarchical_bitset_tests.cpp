@@ -0,0 +1,112 @@
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "ass/hierarchical_bitset.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+static_assert(HierarchicalBitset<0>::kLevelsCount == 1);
+static_assert(HierarchicalBitset<64>::kLevelsCount == 1);
+static_assert(HierarchicalBitset<65>::kLevelsCount == 2);
+static_assert(HierarchicalBitset<64 * 64>::kLevelsCount == 2);
+static_assert(HierarchicalBitset<1'000'000>::kLevelsCount == 4);
+
+template <size_t size>
+void CheckHierarchicalBitset(const size_t iterations_count, const size_t max_index)
+{
+    constexpr unsigned seed = 42;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> index_distribution(0, max_index);
+    std::bernoulli_distribution value_distribution(0.6);
+
+    // Large bitsets do not fit on the stack
+    auto bitset = std::make_unique<HierarchicalBitset<size>>();
+    std::set<size_t> expected;
+
+    for (size_t iteration = 0; iteration != iterations_count; ++iteration)
+    {
+        const size_t index = index_distribution(gen);
+        const bool value = value_distribution(gen);
+        const bool changed = value ? expected.insert(index).second : expected.erase(index) != 0;
+        ASSERT_EQ(bitset->Set(index, value), changed);
+        ASSERT_EQ(bitset->Get(index), value);
+        ASSERT_EQ(bitset->Any(), !expected.empty());
+
+        // Probe search around the changed index and at random places
+        for (const size_t from : {index, index + 1, index_distribution(gen), size_t{0}})
+        {
+            auto next = expected.lower_bound(from);
+            ASSERT_EQ(bitset->FindNextSet(from), next == expected.end() ? size : *next) << "from: " << from;
+
+            auto prev = expected.upper_bound(from);
+            const size_t expected_prev = prev == expected.begin() ? size : *std::prev(prev);
+            ASSERT_EQ(bitset->FindPrevSet(from), expected_prev) << "from: " << from;
+        }
+    }
+
+    ASSERT_EQ(bitset->CountOnes(), expected.size());
+
+    std::vector<size_t> visited;
+    bitset->ForEachSetBit(
+        [&](const size_t index)
+        {
+            visited.push_back(index);
+        });
+    ASSERT_EQ(visited, std::vector<size_t>(expected.begin(), expected.end()));
+
+    bitset->Clear();
+    ASSERT_TRUE(bitset->None());
+    ASSERT_EQ(bitset->FindNextSet(), size);
+}
+
+TEST(HierarchicalBitsetTest, Small)
+{
+    CheckHierarchicalBitset<1>(100, 0);
+    CheckHierarchicalBitset<13>(1'000, 12);
+    CheckHierarchicalBitset<64>(1'000, 63);
+}
+
+TEST(HierarchicalBitsetTest, TwoLevels)
+{
+    CheckHierarchicalBitset<65>(2'000, 64);
+    CheckHierarchicalBitset<4'000>(10'000, 3'999);
+}
+
+TEST(HierarchicalBitsetTest, Sparse)
+{
+    // A few hundred bits spread over a million
+    CheckHierarchicalBitset<1'000'000>(2'000, 999'999);
+}
+
+TEST(HierarchicalBitsetTest, Clustered)
+{
+    // Bits are set and reset near the end so summaries are emptied and filled back many times
+    CheckHierarchicalBitset<300'000>(20'000, 299'999);
+    CheckHierarchicalBitset<262'144>(20'000, 262'143);
+}
+
+static constexpr bool ConstexprTest()
+{
+    HierarchicalBitset<10'000> bitset;
+    bitset.Set(5, true);
+    bitset.Set(9'000, true);
+    bitset.Set(9'999, true);
+    bitset.Set(9'999, false);
+
+    size_t sum = 0;
+    bitset.ForEachSetBit(
+        [&](const size_t index)
+        {
+            sum += index;
+        });
+
+    return bitset.FindNextSet() == 5 && bitset.FindNextSet(6) == 9'000 && bitset.FindNextSet(9'001) == 10'000 &&
+           bitset.FindPrevSet() == 9'000 && bitset.FindPrevSet(8'999) == 5 && bitset.CountOnes() == 2 &&
+           sum == 9'005;
+}
+
+static_assert(ConstexprTest());
+}  // namespace ass
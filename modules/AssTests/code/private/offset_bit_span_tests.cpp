@@ -0,0 +1,125 @@
+#include <array>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ass/bit_span.hpp"
+#include "ass/fixed_bitset.hpp"
+#include "ass/offset_bit_span.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+template <typename Part>
+void CheckOffsetBitSpan()
+{
+    constexpr unsigned seed = 42;
+    constexpr size_t size = 2000;
+    constexpr size_t bits_per_part = sizeof(Part) * 8;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> index_distribution(0, size - 1);
+    std::uniform_int_distribution<Part> part_distribution;
+
+    std::vector<Part> a_parts(size / bits_per_part + 1);
+    std::vector<Part> b_parts(size / bits_per_part + 1);
+    for (Part& part : a_parts) part = part_distribution(gen);
+    for (Part& part : b_parts) part = part_distribution(gen);
+    const auto a = ToBitSpan(std::span{a_parts}, {.size = size});
+    const auto b = ToBitSpan(std::span{b_parts}, {.size = size});
+
+    for (size_t iteration = 0; iteration != 300; ++iteration)
+    {
+        const size_t a_offset = index_distribution(gen);
+        const size_t b_offset = index_distribution(gen);
+        const size_t count = std::min(size - a_offset, size - b_offset) * (iteration % 4) / 3;
+
+        const std::vector<Part> a_before = a_parts;
+        const auto sa = a.Subspan(a_offset, count);
+        const auto sb = b.Subspan(b_offset, count);
+        ASSERT_EQ(sa.GetSize(), count);
+        ASSERT_EQ(sa.GetBitOffset(), a_offset % bits_per_part);
+
+        size_t expected_count = 0;
+        size_t expected_next = count;
+        for (size_t i = 0; i != count; ++i)
+        {
+            ASSERT_EQ(sa.Get(i), a.Get(a_offset + i));
+            expected_count += a.Get(a_offset + i);
+            if (expected_next == count && a.Get(a_offset + i)) expected_next = i;
+        }
+        ASSERT_EQ(sa.CountOnes(), expected_count);
+        ASSERT_EQ(ToBitExpression(sa).CountOnes(), expected_count);
+        ASSERT_EQ(sa.FindNextSet(), expected_next);
+
+        switch (iteration % 3)
+        {
+        case 0:
+            sa.XorAssign(sb);
+            break;
+        case 1:
+            sa.Assign(Lazy(sa) & ~Lazy(sb));
+            break;
+        default:
+            sa.OrAssign(sb);
+            break;
+        }
+
+        // Bits inside the view follow the operation and bits outside are untouched
+        const auto before = ToBitSpan(std::span<const Part>{a_before}, {.size = size});
+        for (size_t i = 0; i != size; ++i)
+        {
+            bool expected = before.Get(i);
+            if (i >= a_offset && i < a_offset + count)
+            {
+                const bool other = b.Get(b_offset + i - a_offset);
+                const bool results[] = {expected != other, expected && !other, expected || other};
+                expected = results[iteration % 3];
+            }
+            ASSERT_EQ(a.Get(i), expected) << "iteration: " << iteration << ", i: " << i;
+        }
+        ASSERT_EQ(a_parts.back() >> (size % bits_per_part), a_before.back() >> (size % bits_per_part));
+    }
+}
+
+TEST(OffsetBitSpanTest, RandomOperations)
+{
+    CheckOffsetBitSpan<uint8_t>();
+    CheckOffsetBitSpan<uint32_t>();
+    CheckOffsetBitSpan<uint64_t>();
+}
+
+TEST(OffsetBitSpanTest, SubspanOfSubspan)
+{
+    std::array<uint64_t, 4> parts{};
+    const auto bits = ToBitSpan<{.size = 256}>(parts);
+    const auto outer = bits.Subspan(37, 200);
+    const auto inner = outer.Subspan(30, 100);
+    ASSERT_EQ(inner.GetBitOffset(), 3);
+    inner.SetRange(0, 100);
+    ASSERT_EQ(bits.CountOnes(), 100);
+    ASSERT_EQ(bits.FindNextSet(), 67);
+    ASSERT_EQ(bits.FindPrevSet(), 166);
+    inner.FlipRange(10, 20);
+    inner.Set(0, false);
+    ASSERT_EQ(outer.CountOnes(30, 130), 89);
+    ASSERT_EQ(outer.FindNextSet(), 31);
+
+    // Offset views take part in expressions together with aligned containers
+    FixedBitset<100> copy = ToBitExpression(inner);
+    ASSERT_EQ(copy.CountOnes(), 89);
+    ASSERT_FALSE(copy.Get(0));
+    ASSERT_TRUE(copy.Get(1));
+}
+
+static constexpr bool OffsetBitSpanConstexprTest()
+{
+    std::array<uint16_t, 4> a{0xFFFF, 0, 0, 0};
+    std::array<uint16_t, 4> b{};
+    const auto sa = ToBitSpan<{.size = 64}>(a).Subspan(4, 20);
+    const auto sb = ToBitSpan<{.size = 64}>(b).Subspan(13, 20);
+    sb.Assign(ToBitExpression(sa));
+    return b[0] == 0xE000 && b[1] == 0x01FF && sb.CountOnes() == 12 && b[2] == 0;
+}
+
+static_assert(OffsetBitSpanConstexprTest());
+}  // namespace ass
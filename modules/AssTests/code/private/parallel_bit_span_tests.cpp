@@ -0,0 +1,154 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ass/parallel_bit_span.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+// Big enough for several threads and several tasks per thread, odd size leaves unused bits in the last part
+constexpr size_t kParallelTestSize = 40'000'003;
+
+std::vector<uint64_t> MakeRandomParts(const size_t size, const unsigned seed)
+{
+    std::mt19937_64 gen(seed);
+    std::vector<uint64_t> parts((size + 63) / 64);
+    for (uint64_t& part : parts) part = gen();
+    return parts;
+}
+
+TEST(ParallelBitSpanTest, GetChunkAlignsToCacheLines)
+{
+    alignas(64) std::array<uint32_t, 1000> parts{};
+    const uint32_t* first = parts.data() + 3;
+    constexpr size_t parts_count = 990;
+    constexpr size_t chunks_count = 7;
+
+    size_t expected_begin = 0;
+    for (size_t chunk_index = 0; chunk_index != chunks_count; ++chunk_index)
+    {
+        const auto range = parallel_bit_span_detail::GetChunk(first, parts_count, chunks_count, chunk_index);
+        ASSERT_EQ(range.begin, expected_begin);
+        ASSERT_LE(range.begin, range.end);
+        if (chunk_index != chunks_count - 1)
+        {
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(first + range.end) % 64, 0);
+        }
+        expected_begin = range.end;
+    }
+    ASSERT_EQ(expected_begin, parts_count);
+
+    // More chunks than cache lines
+    size_t covered = 0;
+    for (size_t chunk_index = 0; chunk_index != 10; ++chunk_index)
+    {
+        const auto range = parallel_bit_span_detail::GetChunk(first, 20, 10, chunk_index);
+        covered += range.end - range.begin;
+    }
+    ASSERT_EQ(covered, 20);
+}
+
+TEST(ParallelBitSpanTest, CountOnes)
+{
+    auto parts = MakeRandomParts(kParallelTestSize, 1);
+    const auto span = ToBitSpan(std::span{parts}, {.size = kParallelTestSize});
+    const size_t expected = span.CountOnes();
+    for (const size_t threads_count : {1, 2, 5, 16})
+    {
+        ASSERT_EQ(ParallelCountOnes(span, threads_count), expected);
+    }
+
+    // Small spans fall back to fewer threads
+    const auto small = ToBitSpan(std::span{parts}, {.size = 1000});
+    ASSERT_EQ(ParallelCountOnes(small, 8), small.CountOnes());
+}
+
+TEST(ParallelBitSpanTest, BinaryOperations)
+{
+    const auto a_parts = MakeRandomParts(kParallelTestSize, 2);
+    const auto b_parts = MakeRandomParts(kParallelTestSize, 3);
+    const auto b = ToBitSpan(std::span{b_parts}, {.size = kParallelTestSize});
+
+    auto check = [&](auto parallel_op, auto op)
+    {
+        auto expected_parts = a_parts;
+        auto actual_parts = a_parts;
+        auto expected = ToBitSpan(std::span{expected_parts}, {.size = kParallelTestSize});
+        const auto actual = ToBitSpan(std::span{actual_parts}, {.size = kParallelTestSize});
+        op(expected);
+        parallel_op(actual);
+        return expected_parts == actual_parts;
+    };
+
+    ASSERT_TRUE(check(
+        [&](const auto& span)
+        {
+            ParallelAndAssign(span, b, 6);
+        },
+        [&](auto& span)
+        {
+            span.AndAssign(b);
+        }));
+    ASSERT_TRUE(check(
+        [&](const auto& span)
+        {
+            ParallelOrAssign(span, b, 6);
+        },
+        [&](auto& span)
+        {
+            span.OrAssign(b);
+        }));
+    ASSERT_TRUE(check(
+        [&](const auto& span)
+        {
+            ParallelXorAssign(span, b, 6);
+        },
+        [&](auto& span)
+        {
+            span.XorAssign(b);
+        }));
+    ASSERT_TRUE(check(
+        [&](const auto& span)
+        {
+            ParallelFlip(span, 6);
+        },
+        [&](auto& span)
+        {
+            span.Flip();
+        }));
+}
+
+TEST(ParallelBitSpanTest, ForEachSetBit)
+{
+    // Dense first half and sparse second half to make threads steal work
+    std::vector<uint64_t> parts((kParallelTestSize + 63) / 64);
+    const auto span = ToBitSpan(std::span{parts}, {.size = kParallelTestSize});
+    span.SetRange(0, kParallelTestSize / 2);
+    for (size_t index = kParallelTestSize / 2; index < kParallelTestSize; index += 997)
+    {
+        span.Set(index, true);
+    }
+    span.Set(kParallelTestSize - 1, true);
+
+    std::vector<uint8_t> visited(kParallelTestSize);
+    std::atomic<size_t> visited_count = 0;
+    ParallelForEachSetBit(
+        span,
+        [&](const size_t index)
+        {
+            ++visited[index];
+            visited_count.fetch_add(1, std::memory_order_relaxed);
+        },
+        8);
+
+    ASSERT_EQ(visited_count.load(), span.CountOnes());
+    for (size_t index = 0; index != kParallelTestSize; ++index)
+    {
+        ASSERT_EQ(visited[index], span.Get(index) ? 1 : 0) << index;
+    }
+}
+}  // namespace ass
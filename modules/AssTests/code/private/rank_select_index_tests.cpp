@@ -0,0 +1,132 @@
+#include <array>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ass/bit_span.hpp"
+#include "ass/rank_select_index.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+template <typename Part>
+void CheckRankSelect(const size_t size, const double density)
+{
+    constexpr unsigned seed = 42;
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution bit_distribution(density);
+
+    constexpr size_t bits_per_part = sizeof(Part) * 8;
+    std::vector<Part> parts((size + bits_per_part - 1) / bits_per_part + 1, 0);
+
+    // Garbage past the size must be ignored
+    parts.back() = static_cast<Part>(~Part{0});
+
+    const auto bits = ToBitSpan(std::span{parts}, {.size = size});
+    std::vector<size_t> ones;
+    for (size_t index = 0; index != size; ++index)
+    {
+        if (bit_distribution(gen))
+        {
+            bits.Set(index, true);
+            ones.push_back(index);
+        }
+    }
+
+    const RankSelectIndex index(bits);
+    ASSERT_EQ(index.GetSize(), size);
+    ASSERT_EQ(index.CountOnes(), ones.size());
+
+    size_t expected_rank = 0;
+    for (size_t i = 0; i <= size; ++i)
+    {
+        ASSERT_EQ(index.Rank1(i), expected_rank) << "i: " << i;
+        ASSERT_EQ(index.Rank0(i), i - expected_rank) << "i: " << i;
+        if (i != size && bits.Get(i)) ++expected_rank;
+    }
+
+    for (size_t k = 0; k != ones.size(); ++k)
+    {
+        ASSERT_EQ(index.Select1(k), ones[k]) << "k: " << k;
+    }
+    ASSERT_EQ(index.Select1(ones.size()), size);
+}
+
+TEST(RankSelectIndexTest, RandomBits)
+{
+    for (const double density : {0.0, 0.001, 0.1, 0.5, 0.97, 1.0})
+    {
+        CheckRankSelect<uint64_t>(20'000, density);
+        CheckRankSelect<uint32_t>(4096 * 3, density);
+        CheckRankSelect<uint8_t>(5'003, density);
+#if ASS_HAS_UINT128
+        CheckRankSelect<Uint128>(9'001, density);
+#endif
+    }
+
+    // Sparse bits: select skips many superblocks
+    CheckRankSelect<uint64_t>(300'000, 0.01);
+
+    CheckRankSelect<uint64_t>(0, 0.5);
+    CheckRankSelect<uint16_t>(1, 1.0);
+}
+
+TEST(RankSelectIndexTest, DenseAndSparseChunks)
+{
+    // Dense run, a long gap, then a dense run again: the gap is inside a dense chunk
+    std::vector<uint64_t> parts(4096, 0);
+    const auto bits = ToBitSpan(std::span{parts}, {.size = parts.size() * 64});
+    bits.SetRange(0, 1500);
+    bits.SetRange(200'000, 202'000);
+    bits.Set(262'000, true);
+
+    const RankSelectIndex index(bits);
+    ASSERT_EQ(index.CountOnes(), 3501);
+    for (size_t k = 0; k != 1500; ++k)
+    {
+        ASSERT_EQ(index.Select1(k), k);
+    }
+    for (size_t k = 1500; k != 3500; ++k)
+    {
+        ASSERT_EQ(index.Select1(k), 200'000 + k - 1500);
+    }
+    ASSERT_EQ(index.Select1(3500), 262'000);
+    ASSERT_EQ(index.Select1(3501), bits.GetSize());
+
+    // Ones of the first chunk span twice the sparse threshold, the second (partial) chunk is dense
+    constexpr size_t ones_per_chunk = rank_select_index_detail::kOnesPerChunk;
+    constexpr size_t stride = 2 * rank_select_index_detail::kSparseChunkBitsCount / ones_per_chunk;
+    constexpr size_t ones_count = ones_per_chunk + ones_per_chunk / 2;
+    std::vector<uint64_t> sparse_parts(ones_count * stride / 64, 0);
+    const auto sparse_bits = ToBitSpan(std::span{sparse_parts}, {.size = ones_count * stride});
+    for (size_t k = 0; k != ones_count; ++k)
+    {
+        sparse_bits.Set(k * stride + k % 7, true);
+    }
+
+    const RankSelectIndex sparse_index(sparse_bits);
+    ASSERT_EQ(sparse_index.CountOnes(), ones_count);
+    for (size_t k = 0; k != ones_count; ++k)
+    {
+        ASSERT_EQ(sparse_index.Select1(k), k * stride + k % 7) << "k: " << k;
+        ASSERT_EQ(sparse_index.Rank1(k * stride + 7), k + 1) << "k: " << k;
+    }
+    ASSERT_EQ(sparse_index.Select1(ones_count), sparse_bits.GetSize());
+}
+
+TEST(RankSelectIndexTest, Rebuild)
+{
+    std::array<uint64_t, 128> parts{};
+    const auto bits = ToBitSpan<{.size = 8000}>(parts);
+    RankSelectIndex index(bits);
+    ASSERT_EQ(index.CountOnes(), 0);
+    ASSERT_EQ(index.Select1(0), 8000);
+
+    bits.SetRange(5000, 7000);
+    index.Rebuild();
+    ASSERT_EQ(index.CountOnes(), 2000);
+    ASSERT_EQ(index.Rank1(6000), 1000);
+    ASSERT_EQ(index.Select1(0), 5000);
+    ASSERT_EQ(index.Select1(1999), 6999);
+}
+}  // namespace ass
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "ass/roaring_bitmap.hpp"
+#include "gtest/gtest.h"
+
+namespace ass
+{
+namespace
+{
+std::vector<uint32_t> ToVector(const RoaringBitmap& bitmap)
+{
+    std::vector<uint32_t> r;
+    bitmap.ForEach(
+        [&](const uint32_t value)
+        {
+            r.push_back(value);
+        });
+    return r;
+}
+
+// Mix of sparse values, dense blocks and runs spread over several chunks
+std::set<uint32_t> MakeValues(const unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::set<uint32_t> values;
+    std::uniform_int_distribution<uint32_t> any_value;
+    for (size_t i = 0; i != 3000; ++i) values.insert(any_value(gen));
+
+    std::uniform_int_distribution<uint32_t> dense_value(0x10000, 0x1FFFF);
+    for (size_t i = 0; i != 20'000; ++i) values.insert(dense_value(gen));
+
+    const uint32_t run_begin = 0x30000 + (seed % 100) * 300;
+    for (uint32_t value = run_begin; value != run_begin + 30'000; ++value) values.insert(value);
+    return values;
+}
+}  // namespace
+
+TEST(RoaringBitmapTest, AddRemoveContains)
+{
+    constexpr unsigned seed = 42;
+    std::mt19937 gen(seed);
+
+    // Small universe so chunks cross the array/bitmap threshold in both directions
+    std::uniform_int_distribution<uint32_t> value_distribution(0x2FFFF, 0x2FFFF + 10'000);
+    std::bernoulli_distribution add_distribution(0.55);
+
+    RoaringBitmap bitmap;
+    std::set<uint32_t> expected;
+    for (size_t iteration = 0; iteration != 100'000; ++iteration)
+    {
+        const uint32_t value = value_distribution(gen);
+        if (add_distribution(gen) || iteration < 20'000)
+        {
+            ASSERT_EQ(bitmap.Add(value), expected.insert(value).second);
+        }
+        else
+        {
+            ASSERT_EQ(bitmap.Remove(value), expected.erase(value) != 0);
+        }
+        ASSERT_TRUE(bitmap.Contains(value) == expected.contains(value));
+    }
+
+    ASSERT_EQ(bitmap.CountOnes(), expected.size());
+    ASSERT_EQ(ToVector(bitmap), std::vector<uint32_t>(expected.begin(), expected.end()));
+
+    for (const uint32_t value : std::vector<uint32_t>(expected.begin(), expected.end()))
+    {
+        ASSERT_TRUE(bitmap.Remove(value));
+    }
+    ASSERT_TRUE(bitmap.IsEmpty());
+}
+
+TEST(RoaringBitmapTest, SetOperations)
+{
+    const std::set<uint32_t> sa = MakeValues(1);
+    const std::set<uint32_t> sb = MakeValues(2);
+
+    std::vector<uint32_t> expected_and;
+    std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected_and));
+    std::vector<uint32_t> expected_or;
+    std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected_or));
+
+    for (const bool optimize : {false, true})
+    {
+        RoaringBitmap a;
+        RoaringBitmap b;
+        for (const uint32_t value : sa) a.Add(value);
+        for (const uint32_t value : sb) b.Add(value);
+        if (optimize)
+        {
+            a.Optimize();
+            b.Optimize();
+        }
+
+        ASSERT_EQ(ToVector(a), std::vector<uint32_t>(sa.begin(), sa.end()));
+        ASSERT_EQ(ToVector(a & b), expected_and);
+        ASSERT_EQ(ToVector(a | b), expected_or);
+        ASSERT_EQ(a.AndCount(b), expected_and.size());
+        ASSERT_EQ(a.OrCount(b), expected_or.size());
+        ASSERT_EQ((a & b).CountOnes(), expected_and.size());
+
+        // Modifications after Optimize bring runs back to arrays or bitmaps
+        a |= b;
+        a.Add(0x30000 + 50'000);
+        ASSERT_TRUE(a.Contains(0x30000 + 50'000));
+        ASSERT_TRUE(a.Remove(0x30000 + 5'000));
+        ASSERT_FALSE(a.Contains(0x30000 + 5'000));
+        ASSERT_EQ(a.CountOnes(), expected_or.size() + (sb.contains(0x30000 + 50'000) ? 0 : 1) - 1);
+    }
+}
+
+TEST(RoaringBitmapTest, Compression)
+{
+    // 10K ids spread over a billion-bit universe
+    constexpr unsigned seed = 7;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> value_distribution(0, 1'000'000'000);
+    RoaringBitmap sparse;
+    while (sparse.CountOnes() != 10'000) sparse.Add(value_distribution(gen));
+    ASSERT_LT(sparse.GetSizeInBytes(), 1'000'000'000 / 8 / 100);
+
+    // Long runs shrink to a few bytes after Optimize
+    RoaringBitmap runs;
+    for (uint32_t value = 100; value != 200'000; ++value) runs.Add(value);
+    const size_t size_before = runs.GetSizeInBytes();
+    runs.Optimize();
+    ASSERT_LT(runs.GetSizeInBytes() * 100, size_before);
+    ASSERT_EQ(runs.CountOnes(), 199'900);
+    ASSERT_TRUE(runs.Contains(100));
+    ASSERT_TRUE(runs.Contains(199'999));
+    ASSERT_FALSE(runs.Contains(99));
+    ASSERT_FALSE(runs.Contains(200'000));
+}
+}  // namespace ass
@@ -0,0 +1,113 @@
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ass/sharded_fixed_map.hpp"
+#include "gtest/gtest.h"
+
+namespace sharded_fixed_map_tests
+{
+struct IdentityHasher
+{
+    constexpr size_t operator()(const uint32_t v) const noexcept
+    {
+        return v;
+    }
+};
+
+using Map = ass::ShardedFixedMap<8, 1024, uint32_t, uint32_t, IdentityHasher>;
+
+TEST(ShardedFixedMapTest, Basic)
+{
+    auto map = std::make_unique<Map>();
+    ASSERT_TRUE(map->TryAdd(1, 10));
+    ASSERT_TRUE(map->TryAdd(2, 20));
+    ASSERT_TRUE(map->TryAdd(1, 11));
+    ASSERT_EQ(map->Size(), 2);
+    ASSERT_EQ(map->Find(1), 11);
+    ASSERT_EQ(map->Find(3), std::nullopt);
+    ASSERT_EQ(map->Remove(2), 20);
+    ASSERT_FALSE(map->Contains(2));
+
+    map->WithLockedShard(
+        1,
+        [](Map::ShardMap& shard)
+        {
+            shard.Get(1) += 1;
+        });
+    ASSERT_EQ(map->Find(1), 12);
+}
+
+TEST(ShardedFixedMapTest, ShardsAreBalanced)
+{
+    std::array<size_t, Map::kShardsCount> counts{};
+    for (uint32_t key = 0; key != 8000; ++key)
+    {
+        ++counts[Map::GetShardIndex(key)];
+    }
+
+    for (const size_t count : counts)
+    {
+        ASSERT_GT(count, 800);
+        ASSERT_LT(count, 1200);
+    }
+}
+
+TEST(ShardedFixedMapTest, ConcurrentAdd)
+{
+    constexpr uint32_t threads_count = 4;
+    constexpr uint32_t keys_per_thread = 1000;
+    auto map = std::make_unique<Map>();
+
+    std::vector<std::thread> threads;
+    for (uint32_t thread_index = 0; thread_index != threads_count; ++thread_index)
+    {
+        threads.emplace_back(
+            [&, thread_index]
+            {
+                for (uint32_t i = 0; i != keys_per_thread; ++i)
+                {
+                    const uint32_t key = i * threads_count + thread_index;
+                    map->TryAdd(key, key * 2);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(map->Size(), threads_count * keys_per_thread);
+    for (uint32_t key = 0; key != threads_count * keys_per_thread; ++key)
+    {
+        ASSERT_EQ(map->Find(key), key * 2);
+    }
+}
+
+TEST(ShardedFixedMapTest, ParallelBuild)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> items;
+    for (uint32_t key = 0; key != 5000; ++key)
+    {
+        items.emplace_back(key * 7, key);
+    }
+
+    for (const size_t threads_count : {1, 3, 8, 100})
+    {
+        auto map = std::make_unique<Map>();
+        ASSERT_TRUE(map->ParallelBuild(items, threads_count));
+        ASSERT_EQ(map->Size(), items.size());
+        for (const auto& [key, value] : items)
+        {
+            ASSERT_EQ(map->Find(key), value) << "threads: " << threads_count;
+        }
+    }
+
+    // Does not fit
+    auto small = std::make_unique<ass::ShardedFixedMap<2, 16, uint32_t, uint32_t, IdentityHasher>>();
+    ASSERT_FALSE(small->ParallelBuild(items, 2));
+    ASSERT_EQ(small->Size(), 32);
+}
+}  // namespace sharded_fixed_map_tests
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "bit_span.hpp"
+
+namespace ass
+{
+// View of externally owned parts where every access goes through std::atomic_ref.
+// Lets several threads set, reset and claim bits of a shared bitmap without locks.
+// Parts must be aligned to std::atomic_ref<Part>::required_alignment and must not be accessed
+// non-atomically while the view is in use. Bits past the size are never modified.
+// Parts are standard unsigned integers: std::atomic_ref over 128-bit parts is not lock-free.
+template <std::unsigned_integral Part>
+class AtomicBitSpan
+{
+public:
+    using AtomicRef = std::atomic_ref<Part>;
+
+    [[nodiscard]] static constexpr size_t BitsPerPart() noexcept
+    {
+        return sizeof(Part) * 8;
+    }
+
+    AtomicBitSpan(Part* parts, BitSpanSize size) noexcept : parts_(parts), size_(size.size)
+    {
+        assert(reinterpret_cast<std::uintptr_t>(parts) % AtomicRef::required_alignment == 0);
+    }
+
+    [[nodiscard]] size_t GetSize() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] size_t GetPartsCount() const noexcept
+    {
+        return (size_ + BitsPerPart() - 1) / BitsPerPart();
+    }
+
+    [[nodiscard]] bool Get(const size_t index, const std::memory_order order = std::memory_order_seq_cst) const
+    {
+        assert(index < size_);
+        return (GetPartRef(index / BitsPerPart()).load(order) & GetBitMask(index)) != 0;
+    }
+
+    // Sets the bit with fetch_or. Returns previous value of the bit.
+    bool Set(const size_t index, const std::memory_order order = std::memory_order_seq_cst) const
+    {
+        assert(index < size_);
+        const Part mask = GetBitMask(index);
+        return (GetPartRef(index / BitsPerPart()).fetch_or(mask, order) & mask) != 0;
+    }
+
+    // Clears the bit with fetch_and. Returns previous value of the bit.
+    bool Reset(const size_t index, const std::memory_order order = std::memory_order_seq_cst) const
+    {
+        assert(index < size_);
+        const Part mask = GetBitMask(index);
+        return (GetPartRef(index / BitsPerPart()).fetch_and(static_cast<Part>(~mask), order) & mask) != 0;
+    }
+
+    // Atomically finds a zero bit, sets it and returns its index. Returns GetSize() if all bits are set.
+    // The search starts at the part of `start_index` and wraps around, so threads that start
+    // at different places rarely compete for the same part.
+    size_t TryClaimFirstZero(const size_t start_index = 0, const std::memory_order order = std::memory_order_acq_rel)
+        const
+    {
+        const size_t parts_count = GetPartsCount();
+        if (parts_count == 0) return size_;
+
+        const size_t start_part = start_index < size_ ? start_index / BitsPerPart() : 0;
+        for (size_t offset = 0; offset != parts_count; ++offset)
+        {
+            const size_t part_index = (start_part + offset) % parts_count;
+            const Part used_mask = GetUsedBitsMask(part_index);
+            AtomicRef part(parts_[part_index]);  // NOLINT
+            Part value = part.load(std::memory_order_relaxed);
+            while (true)
+            {
+                const Part zeros = static_cast<Part>(~value & used_mask);
+                if (zeros == 0) break;
+
+                const Part bit = static_cast<Part>(zeros & (~zeros + 1));
+                if (part.compare_exchange_weak(value, static_cast<Part>(value | bit), order, std::memory_order_relaxed))
+                {
+                    return part_index * BitsPerPart() + static_cast<size_t>(std::countr_zero(bit));
+                }
+            }
+        }
+
+        return size_;
+    }
+
+    // Not a snapshot if other threads modify bits concurrently
+    [[nodiscard]] size_t CountOnes(const std::memory_order order = std::memory_order_seq_cst) const
+    {
+        size_t n = 0;
+        const size_t parts_count = GetPartsCount();
+        for (size_t part_index = 0; part_index != parts_count; ++part_index)
+        {
+            const Part part = GetPartRef(part_index).load(order);
+            n += static_cast<size_t>(std::popcount(static_cast<Part>(part & GetUsedBitsMask(part_index))));
+        }
+        return n;
+    }
+
+private:
+    [[nodiscard]] AtomicRef GetPartRef(const size_t part_index) const noexcept
+    {
+        return AtomicRef(parts_[part_index]);  // NOLINT
+    }
+
+    [[nodiscard]] static constexpr Part GetBitMask(const size_t index) noexcept
+    {
+        return static_cast<Part>(Part{1} << (index % BitsPerPart()));
+    }
+
+    [[nodiscard]] Part GetUsedBitsMask(const size_t part_index) const noexcept
+    {
+        const size_t used_bits = size_ - part_index * BitsPerPart();
+        if (used_bits >= BitsPerPart()) return std::numeric_limits<Part>::max();
+        return static_cast<Part>(~(std::numeric_limits<Part>::max() << used_bits));
+    }
+
+private:
+    Part* parts_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <std::unsigned_integral Part, size_t span_extent>
+[[nodiscard]] AtomicBitSpan<Part> ToAtomicBitSpan(std::span<Part, span_extent> parts, BitSpanSize size)
+{
+    assert(size.size <= parts.size_bytes() * 8);
+    return AtomicBitSpan<Part>(parts.data(), size);
+}
+}  // namespace ass
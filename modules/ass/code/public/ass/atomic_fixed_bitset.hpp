@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "atomic_bit_span.hpp"
+#include "fixed_bitset.hpp"
+
+namespace ass
+{
+// Fixed size bitset which can be modified by several threads without locks.
+// Set and Reset are single fetch_or/fetch_and and report the previous value of the bit,
+// TryClaimFirstZero atomically finds and sets a zero bit which makes it a lock-free slot allocator.
+// All accesses go through AtomicBitSpan over owned parts.
+template <size_t kSize>
+class AtomicFixedBitset
+{
+public:
+    static constexpr size_t kPartBitsCount = fixed_bitset_detail::GetOptimalPartSize(kSize);
+    static constexpr size_t kPartsCount = fixed_bitset_detail::GetRequiredPartsCount(kSize, kPartBitsCount);
+    using Part = BitsCountToUnsignedIntT<kPartBitsCount>;
+
+    AtomicFixedBitset() = default;
+    AtomicFixedBitset(const AtomicFixedBitset&) = delete;
+    AtomicFixedBitset& operator=(const AtomicFixedBitset&) = delete;
+
+    static constexpr size_t Size() noexcept
+    {
+        return kSize;
+    }
+
+    [[nodiscard]] AtomicBitSpan<Part> GetSpan() noexcept
+    {
+        return AtomicBitSpan<Part>(parts_.data(), {.size = kSize});
+    }
+
+    [[nodiscard]] bool Get(const size_t index, const std::memory_order order = std::memory_order_seq_cst) const
+    {
+        return GetConstSpan().Get(index, order);
+    }
+
+    // Returns previous value of the bit
+    bool Set(const size_t index, const std::memory_order order = std::memory_order_seq_cst)
+    {
+        return GetSpan().Set(index, order);
+    }
+
+    // Returns previous value of the bit
+    bool Reset(const size_t index, const std::memory_order order = std::memory_order_seq_cst)
+    {
+        return GetSpan().Reset(index, order);
+    }
+
+    // Returns index of the claimed bit or kSize if all bits are set
+    size_t TryClaimFirstZero(const size_t start_index = 0, const std::memory_order order = std::memory_order_acq_rel)
+    {
+        return GetSpan().TryClaimFirstZero(start_index, order);
+    }
+
+    [[nodiscard]] size_t CountOnes(const std::memory_order order = std::memory_order_seq_cst) const
+    {
+        return GetConstSpan().CountOnes(order);
+    }
+
+private:
+    // atomic_ref needs a mutable object even for loads
+    [[nodiscard]] AtomicBitSpan<Part> GetConstSpan() const noexcept
+    {
+        return const_cast<AtomicFixedBitset*>(this)->GetSpan();  // NOLINT
+    }
+
+private:
+    alignas(std::atomic_ref<Part>::required_alignment) std::array<Part, kPartsCount> parts_{};
+};
+}  // namespace ass
@@ -3,6 +3,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "bit_part.hpp"
+
 namespace ass
 {
 template <size_t bits_count>
@@ -10,6 +12,14 @@ struct BitsCountToUnsignedInt;
 
 inline constexpr size_t kBitsInByte = 8;
 
+#if ASS_HAS_UINT128
+template <>
+struct BitsCountToUnsignedInt<sizeof(Uint128) * kBitsInByte>
+{
+    using Type = Uint128;
+};
+#endif
+
 template <>
 struct BitsCountToUnsignedInt<sizeof(uint64_t) * kBitsInByte>
 {
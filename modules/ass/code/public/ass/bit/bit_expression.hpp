@@ -0,0 +1,281 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "bit_part.hpp"
+
+namespace ass
+{
+// Lazy bitwise expressions over FixedBitset, BitSpan and EnumSet.
+// Lazy evaluation is explicit: `Lazy(a) & ~Lazy(b) | c` builds a tree of small nodes instead of temporaries,
+// and the whole tree is evaluated part by part in a single pass when it is assigned or queried with CountOnes/Any.
+// Operators below apply only when at least one operand is already an expression node, so `a & b` on
+// containers keeps returning an independent value.
+// Nodes keep pointers to the operand data. Containers can join an expression only as lvalues,
+// but an expression stored in a variable still observes later changes of its operands.
+//
+// A container takes part in expressions by providing `ToBitExpression(const Container&)` found by ADL.
+// All operands of one expression must have the same part type and the same size.
+template <typename Derived>
+class BitExpression
+{
+public:
+    [[nodiscard]] constexpr const Derived& Self() const noexcept
+    {
+        return static_cast<const Derived&>(*this);
+    }
+
+    [[nodiscard]] constexpr size_t GetPartsCount() const noexcept
+    {
+        constexpr size_t bits_per_part = sizeof(typename Derived::Part) * 8;
+        return (Self().GetSize() + bits_per_part - 1) / bits_per_part;
+    }
+
+    [[nodiscard]] constexpr bool Get(const size_t index) const
+    {
+        using Part = typename Derived::Part;
+        constexpr size_t bits_per_part = sizeof(Part) * 8;
+        assert(index < Self().GetSize());
+        return (Self().GetPart(index / bits_per_part) & (Part{1} << (index % bits_per_part))) != 0;
+    }
+
+    // Evaluated part with bits past the size cleared
+    [[nodiscard]] constexpr auto GetMaskedPart(const size_t part_index) const noexcept
+    {
+        return MaskUnusedBits(part_index, Self().GetPart(part_index));
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes() const noexcept
+    {
+        size_t n = 0;
+        const size_t parts_count = GetPartsCount();
+        for (size_t part_index = 0; part_index != parts_count; ++part_index)
+        {
+            n += static_cast<size_t>(bit_part_detail::PopCount(GetMaskedPart(part_index)));
+        }
+        return n;
+    }
+
+    // Predicates below stop at the first part that decides the answer
+
+    [[nodiscard]] constexpr bool Any() const noexcept
+    {
+        const size_t parts_count = GetPartsCount();
+        for (size_t part_index = 0; part_index != parts_count; ++part_index)
+        {
+            if (GetMaskedPart(part_index) != 0) return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] constexpr bool None() const noexcept
+    {
+        return !Any();
+    }
+
+    [[nodiscard]] constexpr bool All() const noexcept
+    {
+        using Part = typename Derived::Part;
+        const size_t parts_count = GetPartsCount();
+        for (size_t part_index = 0; part_index != parts_count; ++part_index)
+        {
+            if (MaskUnusedBits(part_index, static_cast<Part>(~Self().GetPart(part_index))) != 0) return false;
+        }
+        return true;
+    }
+
+private:
+    template <typename Part>
+    [[nodiscard]] constexpr Part MaskUnusedBits(const size_t part_index, const Part part) const noexcept
+    {
+        constexpr size_t bits_per_part = sizeof(Part) * 8;
+        const size_t used_bits = Self().GetSize() - part_index * bits_per_part;
+        if (used_bits >= bits_per_part) return part;
+        return static_cast<Part>(part & ~(std::numeric_limits<Part>::max() << used_bits));
+    }
+};
+
+// Expression node, as opposed to a container that can be used as an operand
+template <typename T>
+concept bit_expression = std::derived_from<std::remove_cvref_t<T>, BitExpression<std::remove_cvref_t<T>>>;
+
+// Leaf node: parts of a container
+template <bit_part Part_>
+class [[nodiscard]] BitPartsExpression : public BitExpression<BitPartsExpression<Part_>>
+{
+public:
+    using Part = Part_;
+
+    constexpr BitPartsExpression(const Part* parts, const size_t size) noexcept : parts_(parts), size_(size) {}
+
+    [[nodiscard]] constexpr size_t GetSize() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr Part GetPart(const size_t part_index) const noexcept
+    {
+        return parts_[part_index];  // NOLINT
+    }
+
+private:
+    const Part* parts_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Leaf node: bits of a container that start at `bit_offset` inside the first part.
+// Every part is merged from two neighbor parts with a funnel shift.
+template <bit_part Part_>
+class [[nodiscard]] OffsetBitPartsExpression : public BitExpression<OffsetBitPartsExpression<Part_>>
+{
+public:
+    using Part = Part_;
+    static constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+
+    constexpr OffsetBitPartsExpression(const Part* parts, const size_t bit_offset, const size_t size) noexcept
+        : parts_(parts),
+          bit_offset_(bit_offset),
+          size_(size)
+    {
+        assert(bit_offset < kBitsPerPart);
+    }
+
+    [[nodiscard]] constexpr size_t GetSize() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr Part GetPart(const size_t part_index) const noexcept
+    {
+        const Part low = parts_[part_index];  // NOLINT
+        if (bit_offset_ == 0) return low;
+
+        // The next part is read only if it holds bits of the view
+        const Part low_bits = static_cast<Part>(low >> bit_offset_);
+        if ((part_index + 1) * kBitsPerPart >= bit_offset_ + size_) return low_bits;
+        return static_cast<Part>(low_bits | (parts_[part_index + 1] << (kBitsPerPart - bit_offset_)));  // NOLINT
+    }
+
+private:
+    const Part* parts_ = nullptr;
+    size_t bit_offset_ = 0;
+    size_t size_ = 0;
+};
+
+template <typename Operand>
+class [[nodiscard]] BitNotExpression : public BitExpression<BitNotExpression<Operand>>
+{
+public:
+    using Part = typename Operand::Part;
+
+    constexpr explicit BitNotExpression(const Operand& operand) noexcept : operand_(operand) {}
+
+    [[nodiscard]] constexpr size_t GetSize() const noexcept
+    {
+        return operand_.GetSize();
+    }
+
+    [[nodiscard]] constexpr Part GetPart(const size_t part_index) const noexcept
+    {
+        return static_cast<Part>(~operand_.GetPart(part_index));
+    }
+
+private:
+    Operand operand_;
+};
+
+template <typename Op, typename Left, typename Right>
+class [[nodiscard]] BitBinaryExpression : public BitExpression<BitBinaryExpression<Op, Left, Right>>
+{
+public:
+    using Part = typename Left::Part;
+    static_assert(std::same_as<Part, typename Right::Part>, "Operands must have the same part type");
+
+    constexpr BitBinaryExpression(const Left& left, const Right& right) noexcept : left_(left), right_(right)
+    {
+        assert(left_.GetSize() == right_.GetSize());
+    }
+
+    [[nodiscard]] constexpr size_t GetSize() const noexcept
+    {
+        return left_.GetSize();
+    }
+
+    [[nodiscard]] constexpr Part GetPart(const size_t part_index) const noexcept
+    {
+        return static_cast<Part>(Op{}(left_.GetPart(part_index), right_.GetPart(part_index)));
+    }
+
+private:
+    Left left_;
+    Right right_;
+};
+
+// Expression nodes are operands too
+template <typename Derived>
+[[nodiscard]] constexpr const Derived& ToBitExpression(const BitExpression<Derived>& expression) noexcept
+{
+    return expression.Self();
+}
+
+template <typename T>
+concept bit_expression_operand = requires(const T& operand) {
+    { ToBitExpression(operand) };
+};
+
+template <typename T>
+using BitExpressionOf = std::remove_cvref_t<decltype(ToBitExpression(std::declval<const T&>()))>;
+
+// Operand that can be stored in an expression node: either a node or a container that outlives the expression
+template <typename T>
+concept lazy_bit_operand =
+    bit_expression<T> || (std::is_lvalue_reference_v<T> && bit_expression_operand<std::remove_cvref_t<T>>);
+
+// Entry point for lazy evaluation: `Lazy(a) & b` evaluates to a node instead of a new container
+template <bit_expression_operand Operand>
+[[nodiscard]] constexpr auto Lazy(const Operand& operand) noexcept
+{
+    return ToBitExpression(operand);
+}
+
+// A temporary container would die before the expression is evaluated
+template <bit_expression_operand Operand>
+    requires(!bit_expression<Operand>)
+void Lazy(const Operand&&) = delete;
+
+template <bit_expression Operand>
+[[nodiscard]] constexpr auto operator~(const Operand& operand) noexcept
+{
+    return BitNotExpression<Operand>(operand);
+}
+
+template <lazy_bit_operand Left, lazy_bit_operand Right>
+    requires(bit_expression<Left> || bit_expression<Right>)
+[[nodiscard]] constexpr auto operator&(Left&& left, Right&& right) noexcept
+{
+    using Expression = BitBinaryExpression<std::bit_and<>, BitExpressionOf<Left>, BitExpressionOf<Right>>;
+    return Expression(ToBitExpression(left), ToBitExpression(right));
+}
+
+template <lazy_bit_operand Left, lazy_bit_operand Right>
+    requires(bit_expression<Left> || bit_expression<Right>)
+[[nodiscard]] constexpr auto operator|(Left&& left, Right&& right) noexcept
+{
+    using Expression = BitBinaryExpression<std::bit_or<>, BitExpressionOf<Left>, BitExpressionOf<Right>>;
+    return Expression(ToBitExpression(left), ToBitExpression(right));
+}
+
+template <lazy_bit_operand Left, lazy_bit_operand Right>
+    requires(bit_expression<Left> || bit_expression<Right>)
+[[nodiscard]] constexpr auto operator^(Left&& left, Right&& right) noexcept
+{
+    using Expression = BitBinaryExpression<std::bit_xor<>, BitExpressionOf<Left>, BitExpressionOf<Right>>;
+    return Expression(ToBitExpression(left), ToBitExpression(right));
+}
+}  // namespace ass
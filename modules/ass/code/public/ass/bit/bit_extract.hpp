@@ -0,0 +1,235 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "bit_expression.hpp"
+#include "bit_part.hpp"
+#include "bit_shift.hpp"
+#include "simd_kernels.hpp"
+
+#if ASS_SIMD_X86 && defined(__x86_64__)
+#define ASS_BIT_EXTRACT_BMI2 1
+#else
+#define ASS_BIT_EXTRACT_BMI2 0
+#endif
+
+// Parallel bit extract and deposit (PEXT/PDEP) over arrays of parts.
+// Extract gathers bits selected by a mask into the lowest bits of the result, deposit scatters the lowest bits
+// of the source into positions selected by a mask. Every part of the mask consumes or produces popcount(mask part)
+// bits, which are funneled across part boundaries of the compact side.
+// On x86-64 with GCC or Clang BMI2 instructions are used when CPUID reports them, otherwise (and during
+// constant evaluation) a loop over set bits of the mask.
+namespace ass::bit_extract_detail
+{
+template <bit_part Part>
+[[nodiscard]] constexpr Part ExtractPartPortable(const Part value, Part mask) noexcept
+{
+    Part result = 0;
+    for (Part bit = 1; mask != 0; bit = static_cast<Part>(bit << 1))
+    {
+        const Part lowest = static_cast<Part>(mask & (0u - mask));
+        if (value & lowest) result |= bit;
+        mask ^= lowest;
+    }
+    return result;
+}
+
+template <bit_part Part>
+[[nodiscard]] constexpr Part DepositPartPortable(const Part value, Part mask) noexcept
+{
+    Part result = 0;
+    for (Part bit = 1; mask != 0; bit = static_cast<Part>(bit << 1))
+    {
+        const Part lowest = static_cast<Part>(mask & (0u - mask));
+        if (value & bit) result |= lowest;
+        mask ^= lowest;
+    }
+    return result;
+}
+
+#if ASS_BIT_EXTRACT_BMI2
+
+__attribute__((target("bmi2"))) inline uint64_t ExtractPartBmi2(const uint64_t value, const uint64_t mask) noexcept
+{
+    return _pext_u64(value, mask);
+}
+
+__attribute__((target("bmi2"))) inline uint64_t DepositPartBmi2(const uint64_t value, const uint64_t mask) noexcept
+{
+    return _pdep_u64(value, mask);
+}
+
+// Checked once, on first call
+inline bool HasBmi2() noexcept
+{
+#if defined(__BMI2__)
+    return true;
+#else
+    static const bool supported = []
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("bmi2") != 0;
+    }();
+    return supported;
+#endif
+}
+
+#endif
+
+template <bool use_bmi2, bit_part Part>
+[[nodiscard]] constexpr Part ExtractPart(const Part value, const Part mask) noexcept
+{
+#if ASS_BIT_EXTRACT_BMI2
+    if constexpr (use_bmi2 && sizeof(Part) <= sizeof(uint64_t))
+    {
+        return static_cast<Part>(ExtractPartBmi2(value, mask));
+    }
+    else if constexpr (use_bmi2)
+    {
+        // 128-bit part: bits extracted from the high half go right after the bits extracted from the low half
+        const auto low_mask = static_cast<uint64_t>(mask);
+        const Part low = ExtractPartBmi2(static_cast<uint64_t>(value), low_mask);
+        const Part high = ExtractPartBmi2(static_cast<uint64_t>(value >> 64), static_cast<uint64_t>(mask >> 64));
+        return static_cast<Part>(low | (high << std::popcount(low_mask)));
+    }
+#endif
+    return ExtractPartPortable(value, mask);
+}
+
+template <bool use_bmi2, bit_part Part>
+[[nodiscard]] constexpr Part DepositPart(const Part value, const Part mask) noexcept
+{
+#if ASS_BIT_EXTRACT_BMI2
+    if constexpr (use_bmi2 && sizeof(Part) <= sizeof(uint64_t))
+    {
+        return static_cast<Part>(DepositPartBmi2(value, mask));
+    }
+    else if constexpr (use_bmi2)
+    {
+        // 128-bit part: the high half of the mask takes the bits left after filling the low half
+        const auto low_mask = static_cast<uint64_t>(mask);
+        const Part low = DepositPartBmi2(static_cast<uint64_t>(value), low_mask);
+        const Part high = DepositPartBmi2(static_cast<uint64_t>(value >> std::popcount(low_mask)),
+                                          static_cast<uint64_t>(mask >> 64));
+        return static_cast<Part>(low | (high << 64));
+    }
+#endif
+    return DepositPartPortable(value, mask);
+}
+
+template <bool use_bmi2, bit_part Part, bit_expression Mask>
+constexpr size_t ExtractBitsImpl(const Part* parts, const Mask& mask, Part* out, const size_t out_size) noexcept
+{
+    constexpr size_t bits_per_part = sizeof(Part) * 8;
+    const bit_shift_detail::MaskedParts<Part> out_view(out, out_size);
+
+    // Extracted bits are accumulated in `pending` and written out when a whole part is ready
+    Part pending = 0;
+    size_t pending_bits = 0;
+    size_t out_index = 0;
+    const size_t parts_count = mask.GetPartsCount();
+    for (size_t part_index = 0; part_index != parts_count; ++part_index)
+    {
+        const Part mask_part = mask.GetMaskedPart(part_index);
+        if (mask_part == 0) continue;
+
+        const Part value = ExtractPart<use_bmi2>(parts[part_index], mask_part);  // NOLINT
+        const size_t value_bits = static_cast<size_t>(bit_part_detail::PopCount(mask_part));
+        pending = static_cast<Part>(pending | (value << pending_bits));
+        pending_bits += value_bits;
+        if (pending_bits >= bits_per_part)
+        {
+            bit_shift_detail::StorePart(out, out_view, out_index++, pending);
+            pending_bits -= bits_per_part;
+            const size_t consumed_bits = value_bits - pending_bits;
+            pending = consumed_bits == bits_per_part ? Part{0} : static_cast<Part>(value >> consumed_bits);
+        }
+    }
+
+    const size_t extracted_count = out_index * bits_per_part + pending_bits;
+    assert(extracted_count <= out_size);
+
+    for (; out_index <= out_view.GetLastIndex(); ++out_index)
+    {
+        bit_shift_detail::StorePart(out, out_view, out_index, pending);
+        pending = 0;
+    }
+
+    return extracted_count;
+}
+
+template <bool use_bmi2, bit_part Part, bit_expression Mask>
+constexpr void DepositBitsImpl(const Part* parts, const size_t size, const Mask& mask, Part* out) noexcept
+{
+    const bit_shift_detail::MaskedParts<Part> source(parts, size);
+    const bit_shift_detail::MaskedParts<Part> out_view(out, mask.GetSize());
+
+    size_t source_index = 0;
+    const size_t parts_count = mask.GetPartsCount();
+    for (size_t part_index = 0; part_index != parts_count; ++part_index)
+    {
+        const Part mask_part = mask.GetMaskedPart(part_index);
+        Part value = 0;
+        if (mask_part != 0)
+        {
+            // Deposit takes only the lowest popcount(mask_part) bits of the value
+            value = DepositPart<use_bmi2>(source.GetShiftedRight(0, source_index), mask_part);
+            source_index += static_cast<size_t>(bit_part_detail::PopCount(mask_part));
+        }
+        bit_shift_detail::StorePart(out, out_view, part_index, value);
+    }
+}
+
+// Writes bits of `parts` selected by the mask to the lowest bits of `out` and zeroes the rest of the first
+// `out_size` bits. Bits of `out` past `out_size` are not touched. `out` may be the same array as `parts`.
+// Returns the number of extracted bits.
+template <bit_part Part, bit_expression Mask>
+constexpr size_t ExtractBits(const Part* parts, const Mask& mask, Part* out, const size_t out_size) noexcept
+{
+    static_assert(std::same_as<typename Mask::Part, Part>, "Mask must have the same part type");
+    if (out_size == 0)
+    {
+        assert(mask.None());
+        return 0;
+    }
+
+#if ASS_BIT_EXTRACT_BMI2
+    if (!std::is_constant_evaluated() && HasBmi2())
+    {
+        return ExtractBitsImpl<true>(parts, mask, out, out_size);
+    }
+#endif
+    return ExtractBitsImpl<false>(parts, mask, out, out_size);
+}
+
+// Writes the lowest bits of the first `size` bits of `parts` to positions of `out` selected by the mask.
+// Other bits of the first mask.GetSize() bits of `out` become zeros. Source bits past `size` read as zeros.
+// `out` must not overlap `parts`.
+template <bit_part Part, bit_expression Mask>
+constexpr void DepositBits(const Part* parts, const size_t size, const Mask& mask, Part* out) noexcept
+{
+    static_assert(std::same_as<typename Mask::Part, Part>, "Mask must have the same part type");
+    if (mask.GetSize() == 0) return;
+
+    if (size == 0)
+    {
+        const Part zero = 0;
+        DepositBitsImpl<false>(&zero, 1, mask, out);
+        return;
+    }
+
+#if ASS_BIT_EXTRACT_BMI2
+    if (!std::is_constant_evaluated() && HasBmi2())
+    {
+        DepositBitsImpl<true>(parts, size, mask, out);
+        return;
+    }
+#endif
+    DepositBitsImpl<false>(parts, size, mask, out);
+}
+}  // namespace ass::bit_extract_detail
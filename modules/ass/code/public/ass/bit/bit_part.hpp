@@ -0,0 +1,89 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Types that can be used as parts of bit arrays: standard unsigned integers and, where the compiler provides it,
+// unsigned __int128. The latter is not std::unsigned_integral in strict ISO mode and std::popcount and friends
+// do not accept it, so bit arrays count bits through the shims below.
+namespace ass
+{
+#if defined(__SIZEOF_INT128__)
+#define ASS_HAS_UINT128 1
+__extension__ using Uint128 = unsigned __int128;
+#else
+#define ASS_HAS_UINT128 0
+#endif
+
+template <typename T>
+concept bit_part = std::unsigned_integral<T>
+#if ASS_HAS_UINT128
+                   || std::same_as<std::remove_cv_t<T>, Uint128>
+#endif
+    ;
+}  // namespace ass
+
+namespace ass::bit_part_detail
+{
+#if ASS_HAS_UINT128
+[[nodiscard]] constexpr uint64_t GetLow(const Uint128 value) noexcept
+{
+    return static_cast<uint64_t>(value);
+}
+
+[[nodiscard]] constexpr uint64_t GetHigh(const Uint128 value) noexcept
+{
+    return static_cast<uint64_t>(value >> 64);
+}
+#endif
+
+template <bit_part Part>
+[[nodiscard]] constexpr int PopCount(const Part value) noexcept
+{
+#if ASS_HAS_UINT128
+    if constexpr (std::same_as<Part, Uint128>)
+    {
+        return std::popcount(GetLow(value)) + std::popcount(GetHigh(value));
+    }
+    else
+#endif
+    {
+        return std::popcount(value);
+    }
+}
+
+template <bit_part Part>
+[[nodiscard]] constexpr int CountRightZero(const Part value) noexcept
+{
+#if ASS_HAS_UINT128
+    if constexpr (std::same_as<Part, Uint128>)
+    {
+        const uint64_t low = GetLow(value);
+        return low != 0 ? std::countr_zero(low) : 64 + std::countr_zero(GetHigh(value));
+    }
+    else
+#endif
+    {
+        return std::countr_zero(value);
+    }
+}
+
+template <bit_part Part>
+[[nodiscard]] constexpr int CountLeftZero(const Part value) noexcept
+{
+#if ASS_HAS_UINT128
+    if constexpr (std::same_as<Part, Uint128>)
+    {
+        const uint64_t high = GetHigh(value);
+        return high != 0 ? std::countl_zero(high) : 64 + std::countl_zero(GetLow(value));
+    }
+    else
+#endif
+    {
+        return std::countl_zero(value);
+    }
+}
+}  // namespace ass::bit_part_detail
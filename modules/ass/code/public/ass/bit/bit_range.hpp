@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "bit_part.hpp"
+#include "simd_kernels.hpp"
+
+namespace ass::bit_range_detail
+{
+enum class RangeOp
+{
+    kSet,
+    kReset,
+    kFlip
+};
+
+template <bit_part Part>
+inline constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+
+template <bit_part Part>
+inline constexpr Part kAllOnes = std::numeric_limits<Part>::max();
+
+// Mask of bits [first_bit, last_bit] inside one part
+template <bit_part Part>
+[[nodiscard]] constexpr Part MakePartMask(const size_t first_bit, const size_t last_bit) noexcept
+{
+    const Part low = static_cast<Part>(kAllOnes<Part> << first_bit);
+    const Part high = static_cast<Part>(kAllOnes<Part> >> (kBitsPerPart<Part> - 1 - last_bit));
+    return static_cast<Part>(low & high);
+}
+
+template <RangeOp op, bit_part Part>
+constexpr void ApplyMask(Part& part, const Part mask) noexcept
+{
+    if constexpr (op == RangeOp::kSet)
+    {
+        part |= mask;
+    }
+    else if constexpr (op == RangeOp::kReset)
+    {
+        part &= static_cast<Part>(~mask);
+    }
+    else
+    {
+        part ^= mask;
+    }
+}
+
+// Applies op to bits [begin, end) of parts array.
+// Only the two edge parts need masks - inner parts are overwritten wholesale (memset for set and reset).
+template <RangeOp op, bit_part Part>
+constexpr void ModifyRange(Part* parts, const size_t begin, const size_t end)
+{
+    assert(begin <= end);
+    if (begin == end) return;
+
+    constexpr size_t bits_per_part = kBitsPerPart<Part>;
+    const size_t first_part = begin / bits_per_part;
+    const size_t last_part = (end - 1) / bits_per_part;
+    const size_t first_bit = begin % bits_per_part;
+    const size_t last_bit = (end - 1) % bits_per_part;
+
+    if (first_part == last_part)
+    {
+        ApplyMask<op>(parts[first_part], MakePartMask<Part>(first_bit, last_bit));
+        return;
+    }
+
+    ApplyMask<op>(parts[first_part], MakePartMask<Part>(first_bit, bits_per_part - 1));
+    ApplyMask<op>(parts[last_part], MakePartMask<Part>(0, last_bit));
+
+    Part* inner_begin = parts + first_part + 1;
+    const size_t inner_count = last_part - first_part - 1;
+    if constexpr (op == RangeOp::kSet)
+    {
+        std::fill_n(inner_begin, inner_count, kAllOnes<Part>);
+    }
+    else if constexpr (op == RangeOp::kReset)
+    {
+        std::fill_n(inner_begin, inner_count, Part{0});
+    }
+    else
+    {
+        if (!std::is_constant_evaluated() && inner_count * sizeof(Part) >= simd::kMinBytesForSimdKernels)
+        {
+            auto* bytes = reinterpret_cast<unsigned char*>(inner_begin);
+            simd::GetBitKernels().not_inplace(bytes, inner_count * sizeof(Part));
+            return;
+        }
+
+        for (size_t index = 0; index != inner_count; ++index)
+        {
+            inner_begin[index] = static_cast<Part>(~inner_begin[index]);
+        }
+    }
+}
+
+// Number of set bits in [begin, end)
+template <bit_part Part>
+[[nodiscard]] constexpr size_t CountOnesInRange(const Part* parts, const size_t begin, const size_t end)
+{
+    assert(begin <= end);
+    if (begin == end) return 0;
+
+    constexpr size_t bits_per_part = kBitsPerPart<Part>;
+    const size_t first_part = begin / bits_per_part;
+    const size_t last_part = (end - 1) / bits_per_part;
+    const size_t first_bit = begin % bits_per_part;
+    const size_t last_bit = (end - 1) % bits_per_part;
+
+    auto count_masked = [&](const size_t part_index, const Part mask)
+    {
+        return static_cast<size_t>(bit_part_detail::PopCount(static_cast<Part>(parts[part_index] & mask)));
+    };
+
+    if (first_part == last_part)
+    {
+        return count_masked(first_part, MakePartMask<Part>(first_bit, last_bit));
+    }
+
+    size_t n = count_masked(first_part, MakePartMask<Part>(first_bit, bits_per_part - 1));
+    n += count_masked(last_part, MakePartMask<Part>(0, last_bit));
+
+    const Part* inner_begin = parts + first_part + 1;
+    const size_t inner_count = last_part - first_part - 1;
+    if (!std::is_constant_evaluated() && inner_count * sizeof(Part) >= simd::kMinBytesForSimdKernels)
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(inner_begin);
+        return n + simd::GetBitKernels().count_ones(bytes, inner_count * sizeof(Part));
+    }
+
+    for (size_t index = 0; index != inner_count; ++index)
+    {
+        n += static_cast<size_t>(bit_part_detail::PopCount(inner_begin[index]));
+    }
+
+    return n;
+}
+}  // namespace ass::bit_range_detail
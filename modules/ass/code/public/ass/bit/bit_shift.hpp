@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+
+#include "bit_part.hpp"
+
+namespace ass::bit_shift_detail
+{
+// Read only view of the first `size` bits of parts array.
+// Bits past the size and parts out of range (including wrapped around "negative" indices) read as zeros.
+template <bit_part Part>
+class MaskedParts
+{
+public:
+    static constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+    static constexpr Part kAllOnes = std::numeric_limits<Part>::max();
+
+    constexpr MaskedParts(const Part* parts, const size_t size) noexcept
+        : parts_(parts),
+          last_index_((size - 1) / kBitsPerPart),
+          last_mask_(size % kBitsPerPart == 0 ? kAllOnes : static_cast<Part>(~(kAllOnes << (size % kBitsPerPart))))
+    {
+        assert(size != 0);
+    }
+
+    [[nodiscard]] constexpr size_t GetLastIndex() const noexcept
+    {
+        return last_index_;
+    }
+
+    [[nodiscard]] constexpr Part GetLastMask() const noexcept
+    {
+        return last_mask_;
+    }
+
+    [[nodiscard]] constexpr Part operator[](const size_t index) const noexcept
+    {
+        if (index < last_index_) return parts_[index];  // NOLINT
+        if (index == last_index_) return parts_[index] & last_mask_;  // NOLINT
+        return 0;
+    }
+
+    // Part `index` of the bit array shifted towards higher bit indices by `shift` bits.
+    // Funnel shift: low bits of the result are carried from the previous part.
+    [[nodiscard]] constexpr Part GetShiftedLeft(const size_t index, const size_t shift) const noexcept
+    {
+        const size_t part_shift = shift / kBitsPerPart;
+        const size_t bit_shift = shift % kBitsPerPart;
+        const Part part = (*this)[index - part_shift];
+        if (bit_shift == 0) return part;
+
+        const Part carry = (*this)[index - part_shift - 1];
+        return static_cast<Part>((part << bit_shift) | (carry >> (kBitsPerPart - bit_shift)));
+    }
+
+    // Part `index` of the bit array shifted towards lower bit indices by `shift` bits
+    [[nodiscard]] constexpr Part GetShiftedRight(const size_t index, const size_t shift) const noexcept
+    {
+        const size_t part_shift = shift / kBitsPerPart;
+        const size_t bit_shift = shift % kBitsPerPart;
+        const Part part = (*this)[index + part_shift];
+        if (bit_shift == 0) return part;
+
+        const Part carry = (*this)[index + part_shift + 1];
+        return static_cast<Part>((part >> bit_shift) | (carry << (kBitsPerPart - bit_shift)));
+    }
+
+private:
+    const Part* parts_ = nullptr;
+    size_t last_index_ = 0;
+    Part last_mask_ = 0;
+};
+
+// Writes the part but keeps bits past the size of the bit array untouched
+template <bit_part Part>
+constexpr void StorePart(Part* parts, const MaskedParts<Part>& view, const size_t index, const Part value) noexcept
+{
+    if (index == view.GetLastIndex())
+    {
+        const Part mask = view.GetLastMask();
+        parts[index] = static_cast<Part>((value & mask) | (parts[index] & ~mask));  // NOLINT
+    }
+    else
+    {
+        parts[index] = value;  // NOLINT
+    }
+}
+
+// Moves bit i of the first `size` bits to i + shift. Vacated bits become zeros.
+template <bit_part Part>
+constexpr void ShiftLeft(Part* parts, const size_t size, size_t shift) noexcept
+{
+    if (size == 0 || shift == 0) return;
+    shift = std::min(shift, size);
+
+    // Top down: every result part depends only on the parts with lower or equal index
+    const MaskedParts<Part> view(parts, size);
+    for (size_t index = view.GetLastIndex() + 1; index-- != 0;)
+    {
+        StorePart(parts, view, index, view.GetShiftedLeft(index, shift));
+    }
+}
+
+// Moves bit i of the first `size` bits to i - shift. Vacated bits become zeros.
+template <bit_part Part>
+constexpr void ShiftRight(Part* parts, const size_t size, size_t shift) noexcept
+{
+    if (size == 0 || shift == 0) return;
+    shift = std::min(shift, size);
+
+    // Bottom up: every result part depends only on the parts with higher or equal index
+    const MaskedParts<Part> view(parts, size);
+    const size_t last_index = view.GetLastIndex();
+    for (size_t index = 0; index <= last_index; ++index)
+    {
+        StorePart(parts, view, index, view.GetShiftedRight(index, shift));
+    }
+}
+
+// Mirrors the bit order of the part: bit i moves to kBitsPerPart - 1 - i
+template <bit_part Part>
+[[nodiscard]] constexpr Part ReverseBits(Part value) noexcept
+{
+    constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+    constexpr Part kAllOnes = std::numeric_limits<Part>::max();
+
+    // Swap halves, then halves of halves and so on. The mask selects the low half of every block of 2 * width bits.
+    for (size_t width = kBitsPerPart / 2; width != 0; width /= 2)
+    {
+        const Part mask = static_cast<Part>(kAllOnes / static_cast<Part>((Part{1} << width) + 1));
+        value = static_cast<Part>(((value >> width) & mask) | ((value & mask) << width));
+    }
+
+    return value;
+}
+
+// Reads `count` (at most one part) bits starting at bit `position` into the lowest bits of the result
+template <bit_part Part>
+[[nodiscard]] constexpr Part LoadBits(const Part* parts, const size_t position, const size_t count) noexcept
+{
+    constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+    const size_t index = position / kBitsPerPart;
+    const size_t offset = position % kBitsPerPart;
+
+    Part value = static_cast<Part>(parts[index] >> offset);  // NOLINT
+    if (offset + count > kBitsPerPart)
+    {
+        value |= static_cast<Part>(parts[index + 1] << (kBitsPerPart - offset));  // NOLINT
+    }
+
+    if (count != kBitsPerPart)
+    {
+        value &= static_cast<Part>(~(std::numeric_limits<Part>::max() << count));
+    }
+
+    return value;
+}
+
+// Writes the lowest `count` (at most one part) bits of the value starting at bit `position`. Other bits are untouched.
+template <bit_part Part>
+constexpr void StoreBits(Part* parts, const size_t position, const size_t count, const Part value) noexcept
+{
+    constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+    const size_t index = position / kBitsPerPart;
+    const size_t offset = position % kBitsPerPart;
+    const Part mask = count == kBitsPerPart ? std::numeric_limits<Part>::max()
+                                            : static_cast<Part>(~(std::numeric_limits<Part>::max() << count));
+
+    Part& low = parts[index];  // NOLINT
+    low = static_cast<Part>((low & ~static_cast<Part>(mask << offset)) | static_cast<Part>((value & mask) << offset));
+    if (offset + count > kBitsPerPart)
+    {
+        const size_t carry_shift = kBitsPerPart - offset;
+        Part& high = parts[index + 1];  // NOLINT
+        high = static_cast<Part>((high & ~(mask >> carry_shift)) | ((value & mask) >> carry_shift));
+    }
+}
+
+// Reverses the order of bits in [begin, end). Swaps up to a part worth of bits from both ends at a time.
+template <bit_part Part>
+constexpr void ReverseRange(Part* parts, size_t begin, size_t end) noexcept
+{
+    constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+    while (end - begin >= 2)
+    {
+        const size_t count = std::min(kBitsPerPart, (end - begin) / 2);
+        const size_t unused = kBitsPerPart - count;
+        const Part low = LoadBits(parts, begin, count);
+        const Part high = LoadBits(parts, end - count, count);
+        StoreBits(parts, begin, count, static_cast<Part>(ReverseBits(high) >> unused));
+        StoreBits(parts, end - count, count, static_cast<Part>(ReverseBits(low) >> unused));
+        begin += count;
+        end -= count;
+    }
+}
+
+// Moves bit i of the first `size` bits to (i + shift) % size.
+// Works in place: whole parts are rotated directly when possible, otherwise by three bit range reversals.
+template <bit_part Part>
+constexpr void RotateLeft(Part* parts, const size_t size, size_t shift) noexcept
+{
+    constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+    if (size == 0) return;
+    shift %= size;
+    if (shift == 0) return;
+
+    const size_t pivot = size - shift;
+    if (size % kBitsPerPart == 0 && shift % kBitsPerPart == 0)
+    {
+        std::rotate(parts, parts + pivot / kBitsPerPart, parts + size / kBitsPerPart);  // NOLINT
+        return;
+    }
+
+    ReverseRange(parts, 0, pivot);
+    ReverseRange(parts, pivot, size);
+    ReverseRange(parts, 0, size);
+}
+}  // namespace ass::bit_shift_detail
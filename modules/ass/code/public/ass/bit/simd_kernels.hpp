@@ -0,0 +1,587 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ASS_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define ASS_SIMD_X86 0
+#endif
+
+// Bulk kernels for bitsets that work on raw bytes.
+// Bitwise operations do not depend on part width, so FixedBitset and BitSpan with any part type
+// share the same kernels. On x86 with GCC or Clang kernels are compiled for several instruction sets
+// using target attributes and the best one is picked once, on first use, according to CPUID.
+// Everywhere else only the scalar kernels are available.
+namespace ass::simd
+{
+enum class SimdLevel : uint8_t
+{
+    kScalar,
+    kSse2,
+    kAvx2,
+    kAvx512,
+};
+
+struct BitKernels
+{
+    void (*and_inplace)(unsigned char* dst, const unsigned char* src, size_t bytes_count) = nullptr;
+    void (*or_inplace)(unsigned char* dst, const unsigned char* src, size_t bytes_count) = nullptr;
+    void (*xor_inplace)(unsigned char* dst, const unsigned char* src, size_t bytes_count) = nullptr;
+    void (*not_inplace)(unsigned char* dst, size_t bytes_count) = nullptr;
+    size_t (*count_ones)(const unsigned char* data, size_t bytes_count) = nullptr;
+
+    // popcount(a ^ b) without writing the xor anywhere: Hamming distance of two bit arrays
+    size_t (*xor_count_ones)(const unsigned char* a, const unsigned char* b, size_t bytes_count) = nullptr;
+};
+
+// Kernels are called only for arrays at least this big. Smaller ones are not worth an indirect call.
+inline constexpr size_t kMinBytesForSimdKernels = 64;
+}  // namespace ass::simd
+
+namespace ass::simd::simd_detail
+{
+inline uint64_t LoadU64(const unsigned char* ptr) noexcept
+{
+    uint64_t v{};
+    std::memcpy(&v, ptr, sizeof(v));
+    return v;
+}
+
+inline void StoreU64(unsigned char* ptr, const uint64_t v) noexcept
+{
+    std::memcpy(ptr, &v, sizeof(v));
+}
+
+template <typename Op>
+inline void BinaryOpScalar(unsigned char* dst, const unsigned char* src, const size_t bytes_count, Op op) noexcept
+{
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes_count; i += sizeof(uint64_t))
+    {
+        StoreU64(dst + i, op(LoadU64(dst + i), LoadU64(src + i)));
+    }
+
+    for (; i != bytes_count; ++i)
+    {
+        dst[i] = static_cast<unsigned char>(op(dst[i], src[i]));
+    }
+}
+
+inline void AndScalar(unsigned char* dst, const unsigned char* src, const size_t bytes_count) noexcept
+{
+    BinaryOpScalar(
+        dst,
+        src,
+        bytes_count,
+        [](auto a, auto b)
+        {
+            return a & b;
+        });
+}
+
+inline void OrScalar(unsigned char* dst, const unsigned char* src, const size_t bytes_count) noexcept
+{
+    BinaryOpScalar(
+        dst,
+        src,
+        bytes_count,
+        [](auto a, auto b)
+        {
+            return a | b;
+        });
+}
+
+inline void XorScalar(unsigned char* dst, const unsigned char* src, const size_t bytes_count) noexcept
+{
+    BinaryOpScalar(
+        dst,
+        src,
+        bytes_count,
+        [](auto a, auto b)
+        {
+            return a ^ b;
+        });
+}
+
+inline void NotScalar(unsigned char* dst, const size_t bytes_count) noexcept
+{
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes_count; i += sizeof(uint64_t))
+    {
+        StoreU64(dst + i, ~LoadU64(dst + i));
+    }
+
+    for (; i != bytes_count; ++i)
+    {
+        dst[i] = static_cast<unsigned char>(~dst[i]);
+    }
+}
+
+inline size_t CountOnesScalar(const unsigned char* data, const size_t bytes_count) noexcept
+{
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes_count; i += sizeof(uint64_t))
+    {
+        n += static_cast<size_t>(std::popcount(LoadU64(data + i)));
+    }
+
+    for (; i != bytes_count; ++i)
+    {
+        n += static_cast<size_t>(std::popcount(data[i]));
+    }
+
+    return n;
+}
+
+inline size_t XorCountOnesScalar(const unsigned char* a, const unsigned char* b, const size_t bytes_count) noexcept
+{
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes_count; i += sizeof(uint64_t))
+    {
+        n += static_cast<size_t>(std::popcount(LoadU64(a + i) ^ LoadU64(b + i)));
+    }
+
+    for (; i != bytes_count; ++i)
+    {
+        n += static_cast<size_t>(std::popcount(static_cast<unsigned char>(a[i] ^ b[i])));
+    }
+
+    return n;
+}
+
+#if ASS_SIMD_X86
+
+// SSE2 is the baseline of x86-64 but may be missing on old 32-bit CPUs
+#define ASS_SIMD_BINARY_OP_KERNEL(name, target_name, vector, load, store, op, tail)                              \
+    __attribute__((target(target_name))) inline void name(                                                       \
+        unsigned char* dst,                                                                                      \
+        const unsigned char* src,                                                                                \
+        const size_t bytes_count) noexcept                                                                       \
+    {                                                                                                            \
+        size_t i = 0;                                                                                            \
+        for (; i + sizeof(vector) <= bytes_count; i += sizeof(vector))                                           \
+        {                                                                                                        \
+            const vector a = load(reinterpret_cast<const vector*>(dst + i));                                     \
+            const vector b = load(reinterpret_cast<const vector*>(src + i));                                     \
+            store(reinterpret_cast<vector*>(dst + i), op(a, b));                                                 \
+        }                                                                                                        \
+        tail(dst + i, src + i, bytes_count - i);                                                                 \
+    }
+
+ASS_SIMD_BINARY_OP_KERNEL(AndSse2, "sse2", __m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_and_si128, AndScalar)
+ASS_SIMD_BINARY_OP_KERNEL(OrSse2, "sse2", __m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_or_si128, OrScalar)
+ASS_SIMD_BINARY_OP_KERNEL(XorSse2, "sse2", __m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_xor_si128, XorScalar)
+
+ASS_SIMD_BINARY_OP_KERNEL(
+    AndAvx2,
+    "avx2",
+    __m256i,
+    _mm256_loadu_si256,
+    _mm256_storeu_si256,
+    _mm256_and_si256,
+    AndSse2)
+ASS_SIMD_BINARY_OP_KERNEL(
+    OrAvx2,
+    "avx2",
+    __m256i,
+    _mm256_loadu_si256,
+    _mm256_storeu_si256,
+    _mm256_or_si256,
+    OrSse2)
+ASS_SIMD_BINARY_OP_KERNEL(
+    XorAvx2,
+    "avx2",
+    __m256i,
+    _mm256_loadu_si256,
+    _mm256_storeu_si256,
+    _mm256_xor_si256,
+    XorSse2)
+
+ASS_SIMD_BINARY_OP_KERNEL(
+    AndAvx512,
+    "avx512f",
+    __m512i,
+    _mm512_loadu_si512,
+    _mm512_storeu_si512,
+    _mm512_and_si512,
+    AndAvx2)
+ASS_SIMD_BINARY_OP_KERNEL(
+    OrAvx512,
+    "avx512f",
+    __m512i,
+    _mm512_loadu_si512,
+    _mm512_storeu_si512,
+    _mm512_or_si512,
+    OrAvx2)
+ASS_SIMD_BINARY_OP_KERNEL(
+    XorAvx512,
+    "avx512f",
+    __m512i,
+    _mm512_loadu_si512,
+    _mm512_storeu_si512,
+    _mm512_xor_si512,
+    XorAvx2)
+
+#undef ASS_SIMD_BINARY_OP_KERNEL
+
+__attribute__((target("sse2"))) inline void NotSse2(unsigned char* dst, const size_t bytes_count) noexcept
+{
+    const __m128i ones = _mm_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + sizeof(__m128i) <= bytes_count; i += sizeof(__m128i))
+    {
+        auto* ptr = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(ptr, _mm_xor_si128(_mm_loadu_si128(ptr), ones));
+    }
+    NotScalar(dst + i, bytes_count - i);
+}
+
+__attribute__((target("avx2"))) inline void NotAvx2(unsigned char* dst, const size_t bytes_count) noexcept
+{
+    const __m256i ones = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + sizeof(__m256i) <= bytes_count; i += sizeof(__m256i))
+    {
+        auto* ptr = reinterpret_cast<__m256i*>(dst + i);
+        _mm256_storeu_si256(ptr, _mm256_xor_si256(_mm256_loadu_si256(ptr), ones));
+    }
+    NotSse2(dst + i, bytes_count - i);
+}
+
+__attribute__((target("avx512f"))) inline void NotAvx512(unsigned char* dst, const size_t bytes_count) noexcept
+{
+    const __m512i ones = _mm512_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + sizeof(__m512i) <= bytes_count; i += sizeof(__m512i))
+    {
+        auto* ptr = reinterpret_cast<__m512i*>(dst + i);
+        _mm512_storeu_si512(ptr, _mm512_xor_si512(_mm512_loadu_si512(ptr), ones));
+    }
+    NotAvx2(dst + i, bytes_count - i);
+}
+
+__attribute__((target("popcnt"))) inline size_t CountOnesPopcnt(
+    const unsigned char* data,
+    const size_t bytes_count) noexcept
+{
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes_count; i += sizeof(uint64_t))
+    {
+        n += static_cast<size_t>(__builtin_popcountll(LoadU64(data + i)));
+    }
+    return n + CountOnesScalar(data + i, bytes_count - i);
+}
+
+__attribute__((target("popcnt"))) inline size_t XorCountOnesPopcnt(
+    const unsigned char* a,
+    const unsigned char* b,
+    const size_t bytes_count) noexcept
+{
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes_count; i += sizeof(uint64_t))
+    {
+        n += static_cast<size_t>(__builtin_popcountll(LoadU64(a + i) ^ LoadU64(b + i)));
+    }
+    return n + XorCountOnesScalar(a + i, b + i, bytes_count - i);
+}
+
+// Sum of the 64-bit lanes. Goes through memory: _mm256_extract_epi64 is not available on 32-bit x86.
+__attribute__((target("avx2"))) inline size_t SumLanesAvx2(const __m256i v) noexcept
+{
+    alignas(sizeof(__m256i)) uint64_t lanes[4];  // NOLINT
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+
+    size_t n = 0;
+    for (const uint64_t lane : lanes) n += static_cast<size_t>(lane);
+    return n;
+}
+
+// Nibble lookup table popcount (Wojciech Mula): vpshufb counts bits of every nibble,
+// vpsadbw sums byte counters into 64-bit lanes.
+__attribute__((target("avx2"))) inline size_t CountOnesAvx2(const unsigned char* data, const size_t bytes_count) noexcept
+{
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + sizeof(__m256i) <= bytes_count; i += sizeof(__m256i))
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i lo = _mm256_and_si256(v, low_mask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        const __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+
+    const size_t n = SumLanesAvx2(acc);
+    return n + CountOnesPopcnt(data + i, bytes_count - i);
+}
+
+__attribute__((target("avx2"))) inline __m256i LoadAvx2(const unsigned char* ptr) noexcept
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+// Per 64-bit lane popcount of a vector with the same nibble lookup as above
+__attribute__((target("avx2"))) inline __m256i PopcountLanesAvx2(const __m256i v) noexcept
+{
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    const __m256i lo = _mm256_and_si256(v, low_mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    const __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+// Carry-save adder: adds three bit vectors bitwise, `low` gets sum bits and `high` gets carry bits
+__attribute__((target("avx2"))) inline void CarrySaveAddAvx2(
+    __m256i& high,
+    __m256i& low,
+    const __m256i a,
+    const __m256i b,
+    const __m256i c) noexcept
+{
+    const __m256i u = _mm256_xor_si256(a, b);
+    high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+    low = _mm256_xor_si256(u, c);
+}
+
+// Harley-Seal popcount (Mula, Kurz, Lemire): a tree of carry-save adders reduces 16 vectors to
+// counters of weight 1, 2, 4, 8 and one vector of weight 16, which is the only one counted per iteration.
+// Several times faster than the lookup kernel on large inputs, the tail goes to the lookup kernel.
+__attribute__((target("avx2"))) inline size_t CountOnesHarleySealAvx2(
+    const unsigned char* data,
+    const size_t bytes_count) noexcept
+{
+    constexpr size_t kBlockBytes = 16 * sizeof(__m256i);
+    __m256i total = _mm256_setzero_si256();
+    __m256i ones = _mm256_setzero_si256();
+    __m256i twos = _mm256_setzero_si256();
+    __m256i fours = _mm256_setzero_si256();
+    __m256i eights = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + kBlockBytes <= bytes_count; i += kBlockBytes)
+    {
+        constexpr size_t w = sizeof(__m256i);
+        __m256i twos_a;
+        __m256i twos_b;
+        __m256i fours_a;
+        __m256i fours_b;
+        __m256i eights_a;
+        __m256i eights_b;
+        __m256i sixteens;
+
+        CarrySaveAddAvx2(twos_a, ones, ones, LoadAvx2(data + i + 0 * w), LoadAvx2(data + i + 1 * w));
+        CarrySaveAddAvx2(twos_b, ones, ones, LoadAvx2(data + i + 2 * w), LoadAvx2(data + i + 3 * w));
+        CarrySaveAddAvx2(fours_a, twos, twos, twos_a, twos_b);
+        CarrySaveAddAvx2(twos_a, ones, ones, LoadAvx2(data + i + 4 * w), LoadAvx2(data + i + 5 * w));
+        CarrySaveAddAvx2(twos_b, ones, ones, LoadAvx2(data + i + 6 * w), LoadAvx2(data + i + 7 * w));
+        CarrySaveAddAvx2(fours_b, twos, twos, twos_a, twos_b);
+        CarrySaveAddAvx2(eights_a, fours, fours, fours_a, fours_b);
+        CarrySaveAddAvx2(twos_a, ones, ones, LoadAvx2(data + i + 8 * w), LoadAvx2(data + i + 9 * w));
+        CarrySaveAddAvx2(twos_b, ones, ones, LoadAvx2(data + i + 10 * w), LoadAvx2(data + i + 11 * w));
+        CarrySaveAddAvx2(fours_a, twos, twos, twos_a, twos_b);
+        CarrySaveAddAvx2(twos_a, ones, ones, LoadAvx2(data + i + 12 * w), LoadAvx2(data + i + 13 * w));
+        CarrySaveAddAvx2(twos_b, ones, ones, LoadAvx2(data + i + 14 * w), LoadAvx2(data + i + 15 * w));
+        CarrySaveAddAvx2(fours_b, twos, twos, twos_a, twos_b);
+        CarrySaveAddAvx2(eights_b, fours, fours, fours_a, fours_b);
+        CarrySaveAddAvx2(sixteens, eights, eights, eights_a, eights_b);
+
+        total = _mm256_add_epi64(total, PopcountLanesAvx2(sixteens));
+    }
+
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(PopcountLanesAvx2(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(PopcountLanesAvx2(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(PopcountLanesAvx2(twos), 1));
+    total = _mm256_add_epi64(total, PopcountLanesAvx2(ones));
+
+    const size_t n = SumLanesAvx2(total);
+    return n + CountOnesAvx2(data + i, bytes_count - i);
+}
+
+// Fingerprints are short (a few vectors), so the lookup kernel is used instead of Harley-Seal
+__attribute__((target("avx2"))) inline size_t XorCountOnesAvx2(
+    const unsigned char* a,
+    const unsigned char* b,
+    const size_t bytes_count) noexcept
+{
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + sizeof(__m256i) <= bytes_count; i += sizeof(__m256i))
+    {
+        acc = _mm256_add_epi64(acc, PopcountLanesAvx2(_mm256_xor_si256(LoadAvx2(a + i), LoadAvx2(b + i))));
+    }
+
+    const size_t n = SumLanesAvx2(acc);
+    return n + XorCountOnesPopcnt(a + i, b + i, bytes_count - i);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq"))) inline size_t CountOnesAvx512(
+    const unsigned char* data,
+    const size_t bytes_count) noexcept
+{
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + sizeof(__m512i) <= bytes_count; i += sizeof(__m512i))
+    {
+        const __m512i v = _mm512_loadu_si512(data + i);
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+    }
+
+    alignas(sizeof(__m512i)) uint64_t lanes[8];  // NOLINT
+    _mm512_store_si512(lanes, acc);
+
+    size_t n = 0;
+    for (const uint64_t lane : lanes) n += static_cast<size_t>(lane);
+    return n + CountOnesPopcnt(data + i, bytes_count - i);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq"))) inline size_t XorCountOnesAvx512(
+    const unsigned char* a,
+    const unsigned char* b,
+    const size_t bytes_count) noexcept
+{
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + sizeof(__m512i) <= bytes_count; i += sizeof(__m512i))
+    {
+        const __m512i v = _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+    }
+
+    alignas(sizeof(__m512i)) uint64_t lanes[8];  // NOLINT
+    _mm512_store_si512(lanes, acc);
+
+    size_t n = 0;
+    for (const uint64_t lane : lanes) n += static_cast<size_t>(lane);
+    return n + XorCountOnesPopcnt(a + i, b + i, bytes_count - i);
+}
+
+inline bool CpuSupports(const SimdLevel level) noexcept
+{
+    __builtin_cpu_init();
+    switch (level)
+    {
+    case SimdLevel::kScalar:
+        return true;
+    case SimdLevel::kSse2:
+        return __builtin_cpu_supports("sse2");
+    case SimdLevel::kAvx2:
+        return __builtin_cpu_supports("avx2");
+    case SimdLevel::kAvx512:
+        return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+}
+
+inline bool CpuSupportsPopcnt() noexcept
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("popcnt");
+}
+
+inline bool CpuSupportsAvx512Popcnt() noexcept
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512vpopcntdq");
+}
+
+#else
+
+inline bool CpuSupports(const SimdLevel level) noexcept
+{
+    return level == SimdLevel::kScalar;
+}
+
+#endif
+
+inline BitKernels MakeBitKernels(const SimdLevel level) noexcept
+{
+    BitKernels k{
+        .and_inplace = AndScalar,
+        .or_inplace = OrScalar,
+        .xor_inplace = XorScalar,
+        .not_inplace = NotScalar,
+        .count_ones = CountOnesScalar,
+        .xor_count_ones = XorCountOnesScalar,
+    };
+
+#if ASS_SIMD_X86
+    switch (level)
+    {
+    case SimdLevel::kScalar:
+        break;
+    case SimdLevel::kSse2:
+        k = {AndSse2, OrSse2, XorSse2, NotSse2, CountOnesScalar, XorCountOnesScalar};
+        break;
+    case SimdLevel::kAvx2:
+        k = {AndAvx2, OrAvx2, XorAvx2, NotAvx2, CountOnesHarleySealAvx2, XorCountOnesAvx2};
+        break;
+    case SimdLevel::kAvx512:
+        k = {AndAvx512, OrAvx512, XorAvx512, NotAvx512, CountOnesHarleySealAvx2, XorCountOnesAvx2};
+        if (CpuSupportsAvx512Popcnt())
+        {
+            k.count_ones = CountOnesAvx512;
+            k.xor_count_ones = XorCountOnesAvx512;
+        }
+        break;
+    }
+
+    // popcnt instruction predates AVX but is not implied by SSE2
+    if (k.count_ones == CountOnesScalar && level != SimdLevel::kScalar && CpuSupportsPopcnt())
+    {
+        k.count_ones = CountOnesPopcnt;
+        k.xor_count_ones = XorCountOnesPopcnt;
+    }
+#else
+    (void)level;
+#endif
+
+    return k;
+}
+}  // namespace ass::simd::simd_detail
+
+namespace ass::simd
+{
+[[nodiscard]] inline bool IsSimdLevelSupported(const SimdLevel level) noexcept
+{
+    return simd_detail::CpuSupports(level);
+}
+
+[[nodiscard]] inline SimdLevel GetBestSupportedSimdLevel() noexcept
+{
+    for (const SimdLevel level : {SimdLevel::kAvx512, SimdLevel::kAvx2, SimdLevel::kSse2})
+    {
+        if (IsSimdLevelSupported(level)) return level;
+    }
+
+    return SimdLevel::kScalar;
+}
+
+// Kernels for the specified level. The caller must make sure the CPU supports it.
+[[nodiscard]] inline BitKernels GetBitKernels(const SimdLevel level) noexcept
+{
+    return simd_detail::MakeBitKernels(level);
+}
+
+// Kernels for the best instruction set of this CPU. Selected once, on first call.
+[[nodiscard]] inline const BitKernels& GetBitKernels() noexcept
+{
+    static const BitKernels kernels = simd_detail::MakeBitKernels(GetBestSupportedSimdLevel());
+    return kernels;
+}
+}  // namespace ass::simd
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bit_span.hpp"
+
+namespace ass::bit_matrix_detail
+{
+inline constexpr size_t kCacheLineBytes = 64;
+inline constexpr size_t kPartsPerCacheLine = kCacheLineBytes / sizeof(uint64_t);
+
+struct alignas(kCacheLineBytes) CacheLine
+{
+    std::array<uint64_t, kPartsPerCacheLine> parts{};
+};
+
+// Transposes 64x64 bit block in place: bit c of block[r] goes to bit r of block[c].
+// Swaps off-diagonal quadrants of halving size (32x32, then 16x16, ... 1x1) with masks and shifts,
+// 6 rounds of 32 word operations instead of 4096 single bit moves.
+constexpr void Transpose64(std::array<uint64_t, 64>& block) noexcept
+{
+    uint64_t mask = 0x0000'0000'FFFF'FFFF;
+    for (size_t width = 32; width != 0; width >>= 1, mask ^= mask << width)
+    {
+        for (size_t row = 0; row < 64; row = ((row | width) + 1) & ~width)
+        {
+            const uint64_t swapped = ((block[row] >> width) ^ block[row | width]) & mask;
+            block[row] ^= swapped << width;
+            block[row | width] ^= swapped;
+        }
+    }
+}
+}  // namespace ass::bit_matrix_detail
+
+namespace ass
+{
+// Matrix of bits stored row by row in one buffer. Every row starts at a cache line and is padded with zeros
+// to a whole number of cache lines, so rows are BitSpan views and row operations use the span SIMD kernels.
+// Typical use is a graph adjacency matrix: row i holds the edges leaving node i.
+class BitMatrix
+{
+    static constexpr size_t kBitsPerPart = 64;
+    static constexpr size_t kPartsPerCacheLine = bit_matrix_detail::kPartsPerCacheLine;
+    static constexpr size_t kBitsPerCacheLine = kBitsPerPart * kPartsPerCacheLine;
+
+public:
+    BitMatrix() = default;
+
+    BitMatrix(const size_t rows_count, const size_t columns_count)
+        : rows_count_(rows_count),
+          columns_count_(columns_count),
+          lines_per_row_((columns_count + kBitsPerCacheLine - 1) / kBitsPerCacheLine),
+          lines_(rows_count * lines_per_row_)
+    {
+    }
+
+    [[nodiscard]] size_t GetRowsCount() const noexcept
+    {
+        return rows_count_;
+    }
+
+    [[nodiscard]] size_t GetColumnsCount() const noexcept
+    {
+        return columns_count_;
+    }
+
+    [[nodiscard]] BitSpan<uint64_t> GetRow(const size_t row) noexcept
+    {
+        assert(row < rows_count_);
+        return BitSpan<uint64_t>(GetRowParts(row), {.parts_count = GetPartsPerRow(), .size = columns_count_});
+    }
+
+    [[nodiscard]] BitSpan<const uint64_t> GetRow(const size_t row) const noexcept
+    {
+        assert(row < rows_count_);
+        return BitSpan<const uint64_t>(GetRowParts(row), {.parts_count = GetPartsPerRow(), .size = columns_count_});
+    }
+
+    [[nodiscard]] bool Get(const size_t row, const size_t column) const
+    {
+        assert(column < columns_count_);
+        return (GetRowParts(row)[column / kBitsPerPart] >> (column % kBitsPerPart)) & 1;  // NOLINT
+    }
+
+    void Set(const size_t row, const size_t column, const bool value)
+    {
+        GetRow(row).Set(column, value);
+    }
+
+    // Row OR-accumulation: destination_row |= source_row
+    void OrRow(const size_t destination_row, const size_t source_row)
+    {
+        GetRow(destination_row).OrAssign(GetRow(source_row));
+    }
+
+    // Cache blocked transposition: every 64x64 tile is gathered into 64 words, transposed in place
+    // and written to the mirrored tile, so both matrices are touched one small tile at a time.
+    [[nodiscard]] BitMatrix Transposed() const
+    {
+        BitMatrix result(columns_count_, rows_count_);
+        std::array<uint64_t, 64> block{};
+        const size_t row_blocks_count = (rows_count_ + 63) / 64;
+        const size_t column_blocks_count = (columns_count_ + 63) / 64;
+        for (size_t row_block = 0; row_block != row_blocks_count; ++row_block)
+        {
+            const size_t rows_in_block = std::min<size_t>(64, rows_count_ - row_block * 64);
+            for (size_t column_block = 0; column_block != column_blocks_count; ++column_block)
+            {
+                // Padding rows of the block read as zeros, padding columns are zeros in memory
+                for (size_t i = 0; i != 64; ++i)
+                {
+                    block[i] = i < rows_in_block ? GetRowParts(row_block * 64 + i)[column_block] : 0;  // NOLINT
+                }
+
+                bit_matrix_detail::Transpose64(block);
+
+                const size_t columns_in_block = std::min<size_t>(64, columns_count_ - column_block * 64);
+                for (size_t i = 0; i != columns_in_block; ++i)
+                {
+                    result.GetRowParts(column_block * 64 + i)[row_block] = block[i];  // NOLINT
+                }
+            }
+        }
+        return result;
+    }
+
+    // Warshall's algorithm with bit-parallel rows: for every intermediate node k, every row that reaches k
+    // gets all nodes reachable from k with one row OR. O(n^3 / 64) word operations in the worst case.
+    // A node reaches itself only through a cycle.
+    void TransitiveClosure()
+    {
+        assert(rows_count_ == columns_count_);
+        for (size_t k = 0; k != rows_count_; ++k)
+        {
+            const auto row_k = GetRow(k);
+            const size_t k_part = k / kBitsPerPart;
+            const uint64_t k_mask = uint64_t{1} << (k % kBitsPerPart);
+            for (size_t i = 0; i != rows_count_; ++i)
+            {
+                if (i == k || (GetRowParts(i)[k_part] & k_mask) == 0) continue;  // NOLINT
+
+                auto row_i = GetRow(i);
+                row_i.OrAssign(row_k);
+            }
+        }
+    }
+
+    [[nodiscard]] friend bool operator==(const BitMatrix& a, const BitMatrix& b) noexcept
+    {
+        if (a.rows_count_ != b.rows_count_ || a.columns_count_ != b.columns_count_) return false;
+
+        return std::equal(
+            a.lines_.begin(),
+            a.lines_.end(),
+            b.lines_.begin(),
+            [](const bit_matrix_detail::CacheLine& x, const bit_matrix_detail::CacheLine& y)
+            {
+                return x.parts == y.parts;
+            });
+    }
+
+private:
+    [[nodiscard]] size_t GetPartsPerRow() const noexcept
+    {
+        return lines_per_row_ * kPartsPerCacheLine;
+    }
+
+    // Rows of a matrix without columns point past the end of the empty buffer and are never dereferenced
+    [[nodiscard]] uint64_t* GetRowParts(const size_t row) noexcept
+    {
+        return reinterpret_cast<uint64_t*>(lines_.data() + row * lines_per_row_);  // NOLINT
+    }
+
+    [[nodiscard]] const uint64_t* GetRowParts(const size_t row) const noexcept
+    {
+        return reinterpret_cast<const uint64_t*>(lines_.data() + row * lines_per_row_);  // NOLINT
+    }
+
+private:
+    size_t rows_count_ = 0;
+    size_t columns_count_ = 0;
+    size_t lines_per_row_ = 0;
+    std::vector<bit_matrix_detail::CacheLine> lines_;
+};
+}  // namespace ass
@@ -1,13 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <bit>
 #include <cassert>
 #include <concepts>
 #include <functional>
+#include <limits>
 #include <span>
+#include <type_traits>
 #include <vector>
 
+#include "bit/bit_expression.hpp"
+#include "bit/bit_extract.hpp"
+#include "bit/bit_part.hpp"
+#include "bit/bit_range.hpp"
+#include "bit/bit_shift.hpp"
+#include "bit/simd_kernels.hpp"
 #include "macro/empty_bases.hpp"
+#include "offset_bit_span.hpp"
 
 namespace ass::bit_span_detail
 {
@@ -17,12 +28,12 @@ struct IsUintStdArrayT : std::false_type
 {
 };
 
-template <std::unsigned_integral T, size_t N>
+template <bit_part T, size_t N>
 struct IsUintStdArrayT<std::array<T, N>> : std::true_type
 {
 };
 
-template <std::unsigned_integral T, size_t N>
+template <bit_part T, size_t N>
 struct IsUintStdArrayT<const std::array<T, N>> : std::true_type
 {
 };
@@ -35,12 +46,12 @@ struct IsUintStdVectorT : std::false_type
 {
 };
 
-template <std::unsigned_integral T, typename Allocator>
+template <bit_part T, typename Allocator>
 struct IsUintStdVectorT<std::vector<T, Allocator>> : std::true_type
 {
 };
 
-template <std::unsigned_integral T, typename Allocator>
+template <bit_part T, typename Allocator>
 struct IsUintStdVectorT<const std::vector<T, Allocator>> : std::true_type
 {
 };
@@ -119,7 +130,7 @@ struct BitSpanPartsCountAndSize
     size_t size = 0;
 };
 
-template <std::unsigned_integral Part, BitSpanStaticExtents static_extents = BitSpanStaticExtents{}>
+template <bit_part Part, BitSpanStaticExtents static_extents = BitSpanStaticExtents{}>
     requires(static_extents.size == std::dynamic_extent || static_extents.parts_count == std::dynamic_extent ||
              static_extents.size <= (8 * static_extents.parts_count * sizeof(Part)))
 class ASS_EMPTY_BASES BitSpan : public bit_span_detail::SizeContainer<static_extents.size>,
@@ -257,11 +268,110 @@ public:
         this->template ApplyInplaceBinaryOp<std::bit_xor<Part>{}>(another);
     }
 
+    // Bit i moves to i + shift, vacated bits become zeros. Bits past the end of the span are not touched.
+    constexpr void ShiftLeft(const size_t shift) const
+        requires(kCanModifyData)
+    {
+        bit_shift_detail::ShiftLeft(parts_, GetSize(), shift);
+    }
+
+    // Bit i moves to i - shift, vacated bits become zeros
+    constexpr void ShiftRight(const size_t shift) const
+        requires(kCanModifyData)
+    {
+        bit_shift_detail::ShiftRight(parts_, GetSize(), shift);
+    }
+
+    // Bit i moves to (i + shift) % GetSize()
+    constexpr void RotateLeft(const size_t shift) const
+        requires(kCanModifyData)
+    {
+        bit_shift_detail::RotateLeft(parts_, GetSize(), shift);
+    }
+
+    // Bit i moves to (i - shift) % GetSize()
+    constexpr void RotateRight(const size_t shift) const
+        requires(kCanModifyData)
+    {
+        const size_t size = GetSize();
+        if (size == 0) return;
+
+        RotateLeft(size - shift % size);
+    }
+
+    // PEXT: bits of this span selected by the mask are packed into the lowest bits of the destination,
+    // the rest of the destination is zeroed. Destination may be this span. Returns the number of packed bits.
+    template <bit_expression_operand Operand, bit_span_detail::is_bit_span Destination>
+    constexpr size_t ExtractBits(const Operand& mask, const Destination& destination) const
+        requires(Destination::kCanModifyData)
+    {
+        const auto mask_expression = ToBitExpression(mask);
+        assert(mask_expression.GetSize() == GetSize());
+        const size_t destination_size = destination.GetSize();
+        if (destination_size == 0)
+        {
+            assert(mask_expression.None());
+            return 0;
+        }
+
+        return bit_extract_detail::ExtractBits<PurePart>(
+            parts_,
+            mask_expression,
+            &destination.GetPart(0),
+            destination_size);
+    }
+
+    // PDEP: the lowest bits of this span are spread to the positions of the destination selected by the mask,
+    // other bits of the destination are zeroed. Destination must not overlap this span.
+    template <bit_expression_operand Operand, bit_span_detail::is_bit_span Destination>
+    constexpr void DepositBits(const Operand& mask, const Destination& destination) const
+        requires(Destination::kCanModifyData)
+    {
+        const auto mask_expression = ToBitExpression(mask);
+        assert(mask_expression.GetSize() == destination.GetSize());
+        if (destination.GetSize() == 0) return;
+
+        bit_extract_detail::DepositBits<PurePart>(parts_, GetSize(), mask_expression, &destination.GetPart(0));
+    }
+
+    // Evaluates lazy expression like `Lazy(a) & ~Lazy(b) | c` (see bit/bit_expression.hpp) in one pass.
+    // Bits past the end of the span are not touched.
+    template <bit_expression Expression>
+    constexpr void Assign(const Expression& expression) const
+        requires(kCanModifyData)
+    {
+        static_assert(std::same_as<typename Expression::Part, PurePart>, "Expression must have the same part type");
+        assert(expression.GetSize() == GetSize());
+        if (GetSize() == 0) return;
+
+        const size_t last_used_part_index = GetLastUsedPartIndex();
+        for (size_t part_index = 0; part_index != last_used_part_index; ++part_index)
+        {
+            parts_[part_index] = expression.GetPart(part_index);  // NOLINT
+        }
+
+        const PurePart mask = GetLastUsedPartMask();
+        PurePart& part = parts_[last_used_part_index];  // NOLINT
+        part = static_cast<PurePart>((expression.GetPart(last_used_part_index) & mask) | (part & ~mask));
+    }
+
+    [[nodiscard]] friend constexpr auto ToBitExpression(const BitSpan& bit_span) noexcept
+    {
+        return BitPartsExpression<PurePart>(bit_span.parts_, bit_span.GetSize());
+    }
+
     [[nodiscard]] constexpr auto& GetPart(size_t index) const
     {
         return parts_[index];  // NOLINT
     }
 
+    // View of bits [bit_offset, bit_offset + bit_count) which does not have to start at a part boundary
+    [[nodiscard]] constexpr OffsetBitSpan<Part> Subspan(const size_t bit_offset, const size_t bit_count) const
+    {
+        assert(bit_offset + bit_count <= GetSize());
+        return OffsetBitSpan<Part>(parts_, bit_offset, bit_count);
+    }
+
     [[nodiscard]] constexpr bool Get(size_t index) const
     {
         assert(index < GetSize());
@@ -286,9 +396,142 @@ public:
         }
     }
 
+    // Predicates and counters below work part by part on the fly: nothing is materialized
+    // and predicates stop at the first part that decides the answer.
+    [[nodiscard]] constexpr bool Any() const noexcept
+    {
+        return ToBitExpression(*this).Any();
+    }
+
+    [[nodiscard]] constexpr bool None() const noexcept
+    {
+        return ToBitExpression(*this).None();
+    }
+
+    [[nodiscard]] constexpr bool All() const noexcept
+    {
+        return ToBitExpression(*this).All();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr bool Intersects(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) & another).Any();
+    }
+
+    // True if every bit set here is also set in another
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr bool IsSubsetOf(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) & ~Lazy(another)).None();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t AndCount(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) & another).CountOnes();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t OrCount(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) | another).CountOnes();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t XorCount(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) ^ another).CountOnes();
+    }
+
+    // Range operations work on half-open interval [begin, end)
+    constexpr void SetRange(const size_t begin, const size_t end) const
+        requires(kCanModifyData)
+    {
+        assert(end <= GetSize());
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kSet>(parts_, begin, end);
+    }
+
+    constexpr void ResetRange(const size_t begin, const size_t end) const
+        requires(kCanModifyData)
+    {
+        assert(end <= GetSize());
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kReset>(parts_, begin, end);
+    }
+
+    constexpr void FlipRange(const size_t begin, const size_t end) const
+        requires(kCanModifyData)
+    {
+        assert(end <= GetSize());
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kFlip>(parts_, begin, end);
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes(const size_t begin, const size_t end) const
+    {
+        assert(end <= GetSize());
+        return bit_range_detail::CountOnesInRange<PurePart>(parts_, begin, end);
+    }
+
+    // Search functions return GetSize() if there is no matching bit
+
+    // Returns index of the first set bit at or after `from_index`
+    [[nodiscard]] constexpr size_t FindNextSet(const size_t from_index = 0) const noexcept
+    {
+        return FindNext<false>(from_index);
+    }
+
+    // Returns index of the first zero bit at or after `from_index`
+    [[nodiscard]] constexpr size_t FindNextZero(const size_t from_index = 0) const noexcept
+    {
+        return FindNext<true>(from_index);
+    }
+
+    // Returns index of the last set bit at or before `from_index`
+    [[nodiscard]] constexpr size_t FindPrevSet(size_t from_index = std::dynamic_extent) const noexcept
+    {
+        const size_t size = GetSize();
+        if (size == 0) return size;
+
+        from_index = std::min(from_index, size - 1);
+        size_t part_index = from_index / BitsPerPart();
+        const size_t bit_index = from_index % BitsPerPart();
+        PurePart part = parts_[part_index] & (kAllOnes >> (BitsPerPart() - 1 - bit_index));  // NOLINT
+        while (part == 0)
+        {
+            if (part_index == 0) return size;
+            part = parts_[--part_index];  // NOLINT
+        }
+
+        return part_index * BitsPerPart() + BitsPerPart() - 1 - static_cast<size_t>(bit_part_detail::CountLeftZero(part));
+    }
+
+    // Calls f(index) for every set bit in ascending order
+    template <typename F>
+    constexpr void ForEachSetBit(F&& f) const
+    {
+        if (GetSize() == 0) return;
+
+        const size_t last_used_part_index = GetLastUsedPartIndex();
+        for (size_t part_index = 0; part_index <= last_used_part_index; ++part_index)
+        {
+            PurePart part = parts_[part_index];  // NOLINT
+            if (part_index == last_used_part_index)
+            {
+                part &= GetLastUsedPartMask();
+            }
+
+            while (part != 0)
+            {
+                const size_t bit_index = static_cast<size_t>(bit_part_detail::CountRightZero(part));
+                part &= static_cast<PurePart>(part - 1);
+                f(part_index * BitsPerPart() + bit_index);
+            }
+        }
+    }
+
 private:
     template <auto op, bit_span_detail::is_bit_span Another>
-    void ApplyInplaceBinaryOp(const Another& another)
+    constexpr void ApplyInplaceBinaryOp(const Another& another)
         requires(kCanModifyData)
     {
         if constexpr (Another::HasStaticSize() && HasStaticSize())
@@ -303,10 +546,13 @@ private:
         if (GetSize() == 0) return;
 
         const size_t last_used_part_index = GetLastUsedPartIndex();
-        for (size_t part_index = 0; part_index != last_used_part_index; ++part_index)
+        if (!ApplyBinaryOpKernel<op>(another, last_used_part_index))
         {
-            auto& part = GetPart(part_index);
-            part = op(part, another.GetPart(part_index));
+            for (size_t part_index = 0; part_index != last_used_part_index; ++part_index)
+            {
+                auto& part = GetPart(part_index);
+                part = op(part, another.GetPart(part_index));
+            }
         }
 
         auto& part = parts_[last_used_part_index];  // NOLINT
@@ -328,13 +574,106 @@ private:
 private:
     using PurePart = std::remove_const_t<Part>;
 
+    static constexpr PurePart kAllOnes = std::numeric_limits<PurePart>::max();
+
+    // Mask of bits of the last used part that belong to the span
+    [[nodiscard]] constexpr PurePart GetLastUsedPartMask() const noexcept
+    {
+        const size_t used_bits_in_last_part = GetUsedBitsCountInLastUsedPart();
+        if (used_bits_in_last_part == 0) return kAllOnes;
+
+        // Modulo keeps the shift in range for static sizes where the branch above is always taken
+        return static_cast<PurePart>(kAllOnes >> ((BitsPerPart() - used_bits_in_last_part) % BitsPerPart()));
+    }
+
+    template <bool zeros>
+    [[nodiscard]] constexpr size_t FindNext(const size_t from_index) const noexcept
+    {
+        const size_t size = GetSize();
+        if (from_index >= size) return size;
+
+        auto read_part = [&](const size_t index)
+        {
+            return zeros ? static_cast<PurePart>(~parts_[index]) : parts_[index];  // NOLINT
+        };
+
+        size_t part_index = from_index / BitsPerPart();
+        const size_t last_used_part_index = GetLastUsedPartIndex();
+        PurePart part = read_part(part_index) & static_cast<PurePart>(kAllOnes << (from_index % BitsPerPart()));
+        while (part == 0)
+        {
+            if (part_index == last_used_part_index) return size;
+            part = read_part(++part_index);
+        }
+
+        // Bits past the end of the span might be set
+        return std::min(part_index * BitsPerPart() + static_cast<size_t>(bit_part_detail::CountRightZero(part)), size);
+    }
+
+    [[nodiscard]] static bool IsWorthSimdKernel(const size_t parts_count) noexcept
+    {
+        return parts_count * sizeof(Part) >= simd::kMinBytesForSimdKernels;
+    }
+
+    [[nodiscard]] unsigned char* GetBytes() const noexcept
+        requires(kCanModifyData)
+    {
+        return reinterpret_cast<unsigned char*>(parts_);
+    }
+
+    [[nodiscard]] const unsigned char* GetConstBytes() const noexcept
+    {
+        return reinterpret_cast<const unsigned char*>(parts_);
+    }
+
+    // Applies op to the first `parts_count` parts with SIMD kernel if op is a known bitwise operation.
+    // Returns false if the caller has to do that with a scalar loop.
+    template <auto op, typename Another>
+    [[nodiscard]] constexpr bool ApplyBinaryOpKernel(const Another& another, const size_t parts_count) const
+    {
+        using AnotherPart = std::remove_cvref_t<decltype(another.GetPart(0))>;
+        if constexpr (std::same_as<AnotherPart, PurePart>)
+        {
+            if (std::is_constant_evaluated() || !IsWorthSimdKernel(parts_count)) return false;
+
+            const simd::BitKernels& kernels = simd::GetBitKernels();
+            const auto* another_bytes = reinterpret_cast<const unsigned char*>(&another.GetPart(0));
+            const size_t bytes_count = parts_count * sizeof(Part);
+            using Op = std::remove_cvref_t<decltype(op)>;
+            if constexpr (std::same_as<Op, std::bit_and<Part>>)
+            {
+                kernels.and_inplace(GetBytes(), another_bytes, bytes_count);
+                return true;
+            }
+            else if constexpr (std::same_as<Op, std::bit_or<Part>>)
+            {
+                kernels.or_inplace(GetBytes(), another_bytes, bytes_count);
+                return true;
+            }
+            else if constexpr (std::same_as<Op, std::bit_xor<Part>>)
+            {
+                kernels.xor_inplace(GetBytes(), another_bytes, bytes_count);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     constexpr void FlipNonEmpty() const
     {
         const size_t last_used_part_index = GetLastUsedPartIndex();
 
-        for (size_t part_index = 0; part_index != last_used_part_index; ++part_index)
+        if (!std::is_constant_evaluated() && IsWorthSimdKernel(last_used_part_index))
+        {
+            simd::GetBitKernels().not_inplace(GetBytes(), last_used_part_index * sizeof(Part));
+        }
+        else
         {
-            parts_[part_index] = ~parts_[part_index];  // NOLINT
+            for (size_t part_index = 0; part_index != last_used_part_index; ++part_index)
+            {
+                parts_[part_index] = ~parts_[part_index];  // NOLINT
+            }
         }
 
         PurePart part = parts_[last_used_part_index];  // NOLINT
@@ -359,9 +698,16 @@ private:
         const size_t last_used_part_index = GetLastUsedPartIndex();
 
         size_t n = 0;
-        for (size_t part_index = 0; part_index != last_used_part_index; ++part_index)
+        if (!std::is_constant_evaluated() && IsWorthSimdKernel(last_used_part_index))
+        {
+            n = simd::GetBitKernels().count_ones(GetConstBytes(), last_used_part_index * sizeof(Part));
+        }
+        else
         {
-            n += std::popcount(parts_[part_index]);  // NOLINT
+            for (size_t part_index = 0; part_index != last_used_part_index; ++part_index)
+            {
+                n += bit_part_detail::PopCount(parts_[part_index]);  // NOLINT
+            }
         }
 
         PurePart part = parts_[last_used_part_index];  // NOLINT
@@ -375,7 +721,7 @@ private:
             part &= mask;
         }
 
-        n += std::popcount(part);
+        n += bit_part_detail::PopCount(part);
 
         return n;
     }
@@ -408,7 +754,7 @@ private:
     Part* parts_ = nullptr;
 };
 
-template <std::unsigned_integral Part, size_t span_extent>
+template <bit_part Part, size_t span_extent>
     requires(span_extent == std::dynamic_extent)
 [[nodiscard]] constexpr auto ToBitSpan(std::span<Part, span_extent> parts, BitSpanSize size)
 {
@@ -416,7 +762,7 @@ template <std::unsigned_integral Part, size_t span_extent>
     return BitSpan<Part>{parts.data(), {.parts_count = parts.size(), .size = size.size}};
 }
 
-template <std::unsigned_integral Part, size_t span_extent>
+template <bit_part Part, size_t span_extent>
     requires(span_extent != std::dynamic_extent)
 [[nodiscard]] constexpr auto ToBitSpan(std::span<Part, span_extent> parts, BitSpanSize size)
 {
@@ -424,7 +770,7 @@ template <std::unsigned_integral Part, size_t span_extent>
     return BitSpan<Part, BitSpanStaticExtents{.parts_count = span_extent}>{parts.data(), {.size = size.size}};
 }
 
-template <BitSpanSize size, std::unsigned_integral Part, size_t span_extent>
+template <BitSpanSize size, bit_part Part, size_t span_extent>
     requires(span_extent != std::dynamic_extent)
 [[nodiscard]] constexpr auto ToBitSpan(std::span<Part, span_extent> parts)
 {
@@ -432,7 +778,7 @@ template <BitSpanSize size, std::unsigned_integral Part, size_t span_extent>
     return BitSpan<Part, BitSpanStaticExtents{.parts_count = span_extent, .size = size.size}>{parts.data()};
 }
 
-template <BitSpanSize size, std::unsigned_integral Part, size_t span_extent>
+template <BitSpanSize size, bit_part Part, size_t span_extent>
     requires(span_extent == std::dynamic_extent)
 [[nodiscard]] constexpr auto ToBitSpan(std::span<Part, span_extent> parts)
 {
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bit/bit_part.hpp"
+#include "bit/simd_kernels.hpp"
+#include "fixed_bitset.hpp"
+
+namespace ass::bitset_index_detail
+{
+// Rows are padded to whole AVX2 vectors and aligned to them
+inline constexpr size_t kRowAlignment = 32;
+
+// Splitting smaller scans between threads costs more than it saves
+inline constexpr size_t kMinRowsPerThread = 16384;
+}  // namespace ass::bitset_index_detail
+
+namespace ass
+{
+struct BitsetIndexMatch
+{
+    size_t distance = 0;
+    size_t index = 0;
+
+    // Closer first, ties are broken by index
+    friend constexpr auto operator<=>(const BitsetIndexMatch&, const BitsetIndexMatch&) = default;
+};
+
+// Brute force nearest neighbour search over binary fingerprints by Hamming distance.
+// Fingerprints live in one contiguous buffer of aligned rows with zero padding, so the distance is a single
+// xor + popcount kernel call (see bit/simd_kernels.hpp) over the row bytes without materializing the xor.
+// Top-K is kept in a bounded max-heap: a candidate costs one comparison unless it beats the current worst match.
+template <size_t kSize, bit_part Part = uint64_t>
+class BitsetIndex
+{
+public:
+    using Bitset = FixedBitset<kSize, Part>;
+
+private:
+    static constexpr size_t kRowAlignment = bitset_index_detail::kRowAlignment;
+    static constexpr size_t kRowBytes = (Bitset::kPartsCount * sizeof(Part) + kRowAlignment - 1) / kRowAlignment *
+                                        kRowAlignment;
+
+    struct alignas(kRowAlignment) Row
+    {
+        std::array<Part, kRowBytes / sizeof(Part)> parts{};
+    };
+    static_assert(sizeof(Row) == kRowBytes);
+
+public:
+    void Reserve(const size_t rows_count)
+    {
+        rows_.reserve(rows_count);
+    }
+
+    // Returns index of the added fingerprint
+    size_t Add(const Bitset& bits)
+    {
+        rows_.push_back(ToRow(bits));
+        return rows_.size() - 1;
+    }
+
+    void Set(const size_t index, const Bitset& bits)
+    {
+        assert(index < rows_.size());
+        rows_[index] = ToRow(bits);
+    }
+
+    [[nodiscard]] Bitset Get(const size_t index) const
+    {
+        assert(index < rows_.size());
+        Bitset bits;
+        std::copy_n(rows_[index].parts.begin(), Bitset::kPartsCount, bits.GetParts().begin());
+        return bits;
+    }
+
+    [[nodiscard]] size_t GetSize() const noexcept
+    {
+        return rows_.size();
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept
+    {
+        return rows_.empty();
+    }
+
+    void Clear() noexcept
+    {
+        rows_.clear();
+    }
+
+    [[nodiscard]] size_t Distance(const Bitset& query, const size_t index) const
+    {
+        assert(index < rows_.size());
+        const Row query_row = ToRow(query);
+        return simd::GetBitKernels().xor_count_ones(GetBytes(query_row), GetBytes(rows_[index]), kRowBytes);
+    }
+
+    // Up to `k` closest fingerprints sorted by distance, ties are broken by index.
+    // Rows are split into contiguous chunks scanned by `threads_count` threads with their own heaps,
+    // heaps are merged at the end, so the result does not depend on the number of threads.
+    [[nodiscard]] std::vector<BitsetIndexMatch> FindNearest(
+        const Bitset& query,
+        const size_t k,
+        size_t threads_count = 1) const
+    {
+        if (k == 0 || rows_.empty()) return {};
+
+        const Row query_row = ToRow(query);
+        const size_t rows_count = rows_.size();
+        const size_t max_threads_count = std::max<size_t>(1, rows_count / bitset_index_detail::kMinRowsPerThread);
+        threads_count = std::clamp<size_t>(threads_count, 1, max_threads_count);
+
+        std::vector<std::vector<BitsetIndexMatch>> heaps(threads_count);
+        auto scan = [&](const size_t thread_index)
+        {
+            const size_t begin = rows_count * thread_index / threads_count;
+            const size_t end = rows_count * (thread_index + 1) / threads_count;
+            ScanRows(query_row, begin, end, k, heaps[thread_index]);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threads_count - 1);
+        for (size_t thread_index = 1; thread_index != threads_count; ++thread_index)
+        {
+            threads.emplace_back(scan, thread_index);
+        }
+        scan(size_t{0});
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        std::vector<BitsetIndexMatch> result = std::move(heaps.front());
+        for (size_t heap_index = 1; heap_index != heaps.size(); ++heap_index)
+        {
+            result.insert(result.end(), heaps[heap_index].begin(), heaps[heap_index].end());
+        }
+        std::ranges::sort(result);
+        result.resize(std::min(result.size(), k));
+        return result;
+    }
+
+private:
+    [[nodiscard]] static Row ToRow(const Bitset& bits) noexcept
+    {
+        // Unused bits of the last part might be set
+        Row row;
+        const auto expression = ToBitExpression(bits);
+        for (size_t part_index = 0; part_index != Bitset::kPartsCount; ++part_index)
+        {
+            row.parts[part_index] = expression.GetMaskedPart(part_index);
+        }
+        return row;
+    }
+
+    [[nodiscard]] static const unsigned char* GetBytes(const Row& row) noexcept
+    {
+        return reinterpret_cast<const unsigned char*>(row.parts.data());
+    }
+
+    void ScanRows(
+        const Row& query_row,
+        const size_t begin,
+        const size_t end,
+        const size_t k,
+        std::vector<BitsetIndexMatch>& heap) const
+    {
+        const auto xor_count_ones = simd::GetBitKernels().xor_count_ones;
+        const unsigned char* query_bytes = GetBytes(query_row);
+        heap.reserve(std::min(k, end - begin));
+        for (size_t index = begin; index != end; ++index)
+        {
+            const size_t distance = xor_count_ones(query_bytes, GetBytes(rows_[index]), kRowBytes);
+            if (heap.size() < k)
+            {
+                heap.push_back({distance, index});
+                std::ranges::push_heap(heap);
+            }
+            else if (distance < heap.front().distance)
+            {
+                // Indices grow, so an equal distance never beats the worst match
+                std::ranges::pop_heap(heap);
+                heap.back() = {distance, index};
+                std::ranges::push_heap(heap);
+            }
+        }
+    }
+
+private:
+    std::vector<Row> rows_;
+};
+}  // namespace ass
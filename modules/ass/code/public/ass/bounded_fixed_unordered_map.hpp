@@ -0,0 +1,456 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "bit/bit_count_to_type.hpp"
+#include "counted_bits.hpp"
+#include "fixed_bitset.hpp"
+#include "fixed_unordered_map.hpp"
+#include "invalid_index.hpp"
+#include "probe_policy.hpp"
+
+namespace ass::bounded_fixed_unordered_map_detail
+{
+// Returns a word where bit i is set if keys[i] == key. Fixed trip count, no early exit.
+// 4 and 8 byte integer keys are compared with SSE2 (baseline on x86-64), several keys per instruction.
+template <typename Mask, size_t count, typename Key>
+constexpr Mask MatchKeys(const Key* keys, const Key& key) noexcept
+{
+    Mask matches = 0;
+    size_t scalar_begin = 0;
+
+#if defined(__SSE2__)
+    if constexpr ((std::integral<Key> || std::is_enum_v<Key>) && (sizeof(Key) == 4 || sizeof(Key) == 8))
+    {
+        if (!std::is_constant_evaluated())
+        {
+            constexpr size_t kKeysPerVector = sizeof(__m128i) / sizeof(Key);
+            constexpr size_t kVectorKeysCount = count - count % kKeysPerVector;
+            using Bits = std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>;
+            const Bits key_bits = std::bit_cast<Bits>(key);
+
+            __m128i needle{};
+            if constexpr (sizeof(Key) == 4)
+            {
+                needle = _mm_set1_epi32(static_cast<int>(key_bits));
+            }
+            else
+            {
+                needle = _mm_set1_epi64x(static_cast<long long>(key_bits));
+            }
+
+            for (size_t index = 0; index != kVectorKeysCount; index += kKeysPerVector)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + index));  // NOLINT
+                __m128i equal = _mm_cmpeq_epi32(v, needle);
+                int lanes = 0;
+                if constexpr (sizeof(Key) == 4)
+                {
+                    lanes = _mm_movemask_ps(_mm_castsi128_ps(equal));
+                }
+                else
+                {
+                    // SSE2 has no 64 bit compare: both 32 bit halves must match
+                    equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+                    lanes = _mm_movemask_pd(_mm_castsi128_pd(equal));
+                }
+                matches = static_cast<Mask>(matches | (static_cast<Mask>(lanes) << index));
+            }
+            scalar_begin = kVectorKeysCount;
+        }
+    }
+#endif
+
+    for (size_t index = scalar_begin; index < count; ++index)
+    {
+        matches = static_cast<Mask>(matches | (static_cast<Mask>(keys[index] == key) << index));  // NOLINT
+    }
+
+    return matches;
+}
+}  // namespace ass::bounded_fixed_unordered_map_detail
+
+namespace ass
+{
+
+// Fixed unordered map with deterministic worst case for every operation.
+// A key is never placed further than `max_probes` slots along its probe sequence.
+// If all of these slots are taken, the key goes to a small fully associative stash instead.
+// Lookup and insert visit at most `max_probes` slots and then scan the whole stash once with a fixed trip count loop
+// that finds both the key and the first free stash slot, so their cost is bounded by `kMaxProbesPerOperation`
+// key comparisons and known at compile time.
+// cached_size has the same meaning as for FixedUnorderedMap.
+template <
+    size_t capacity,
+    typename Key_,
+    typename Value_,
+    typename Hasher_,
+    size_t max_probes,
+    size_t stash_capacity,
+    typename ProbePolicy_ = LinearProbing,
+    bool cached_size = false>
+class BoundedFixedUnorderedMap
+{
+public:
+    using Key = Key_;
+    using Value = Value_;
+    using Hasher = Hasher_;
+    using ProbePolicy = ProbePolicy_;
+    using ProbeSequence = typename ProbePolicy::template Sequence<capacity>;
+    using Self =
+        BoundedFixedUnorderedMap<capacity, Key, Value, Hasher, max_probes, stash_capacity, ProbePolicy, cached_size>;
+    using Iterator = FixedUnorderedMapIterator<Self>;
+    using ConstIterator = FixedUnorderedMapIterator<std::add_const_t<Self>>;
+    friend Iterator;
+    friend ConstIterator;
+
+    static_assert(max_probes != 0 || capacity == 0);
+    static_assert(max_probes <= capacity);
+    static_assert(stash_capacity <= 64, "Stash occupancy must fit into one word");
+
+    // Slots of the main table followed by stash slots
+    static constexpr size_t kSlotsCount = capacity + stash_capacity;
+    static constexpr size_t kMaxProbes = max_probes;
+    static constexpr size_t kStashCapacity = stash_capacity;
+    static constexpr size_t kMaxProbesPerOperation = max_probes + stash_capacity;
+    static constexpr bool kCachedSize = cached_size;
+
+    constexpr BoundedFixedUnorderedMap() = default;
+
+    static constexpr size_t Capacity() noexcept
+    {
+        return kSlotsCount;
+    }
+
+    constexpr bool Contains(const Key& key) const
+    {
+        return FindKeyIndex(key) != kInvalidIndex;
+    }
+
+    constexpr Value& Get(const Key& key)
+    {
+        const size_t index = FindKeyIndex(key);
+        assert(index != kInvalidIndex);
+        return values_[index];
+    }
+
+    constexpr const Value& Get(const Key& key) const
+    {
+        const size_t index = FindKeyIndex(key);
+        assert(index != kInvalidIndex);
+        return values_[index];
+    }
+
+    [[nodiscard]] constexpr Value* Find(const Key& key)
+    {
+        const size_t index = FindKeyIndex(key);
+        return index == kInvalidIndex ? nullptr : &values_[index];
+    }
+
+    [[nodiscard]] constexpr const Value* Find(const Key& key) const
+    {
+        const size_t index = FindKeyIndex(key);
+        return index == kInvalidIndex ? nullptr : &values_[index];
+    }
+
+    template <typename... Args>
+    constexpr Value* TryEmplace(const Key& key, Args&&... args)
+    {
+        const size_t index = FindSlotForKey(key);
+        if (index == kInvalidIndex)
+        {
+            return nullptr;
+        }
+
+        if (SetOccupied(index, true))
+        {
+            keys_[index] = key;
+            was_deleted_.Set(index, false);
+        }
+
+        Value& value = values_[index];
+        value = Value(std::forward<Args>(args)...);
+        return &value;
+    }
+
+    template <typename... Args>
+    constexpr Value& Emplace(const Key& key, Args&&... args)
+    {
+        auto ptr = TryEmplace(key, std::forward<Args>(args)...);
+        assert(ptr);
+        return *ptr;
+    }
+
+    constexpr Value* TryAdd(const Key& key, std::optional<Value> value = std::nullopt)
+    {
+        const size_t index = FindSlotForKey(key);
+        if (index == kInvalidIndex)
+        {
+            return nullptr;
+        }
+
+        const bool must_init = SetOccupied(index, true);
+        if (must_init)
+        {
+            keys_[index] = key;
+            was_deleted_.Set(index, false);
+        }
+
+        Value& value_ref = values_[index];
+        if (value != std::nullopt)
+        {
+            value_ref = std::move(*value);
+        }
+        else if (must_init)
+        {
+            value_ref = Value{};
+        }
+
+        return &value_ref;
+    }
+
+    constexpr Value& Add(const Key& key, std::optional<Value> value = std::nullopt)
+    {
+        auto ptr = TryAdd(key, std::move(value));
+        assert(ptr);
+        return *ptr;
+    }
+
+    constexpr std::optional<Value> Remove(const Key& key)
+    {
+        const size_t index = FindKeyIndex(key);
+        if (index == kInvalidIndex)
+        {
+            return std::nullopt;
+        }
+
+        SetOccupied(index, false);
+        was_deleted_.Set(index, true);
+        return std::move(values_[index]);
+    }
+
+    constexpr size_t Size() const
+    {
+        return has_index_.CountOnes();
+    }
+
+    // Number of keys that did not fit into their probe window
+    constexpr size_t StashSize() const
+    {
+        return static_cast<size_t>(std::popcount(stash_occupancy_));
+    }
+
+    // STL conformance
+    constexpr Iterator begin() noexcept
+    {
+        return Iterator(*this, GetFirstIndexWithValue());
+    }
+
+    constexpr ConstIterator begin() const noexcept
+    {
+        return cbegin();
+    }
+
+    constexpr ConstIterator cbegin() const noexcept
+    {
+        return ConstIterator(*this, GetFirstIndexWithValue());
+    }
+
+    constexpr Iterator end() noexcept
+    {
+        return Iterator(*this, kSlotsCount);
+    }
+
+    constexpr ConstIterator end() const noexcept
+    {
+        return cend();
+    }
+
+    constexpr ConstIterator cend() const noexcept
+    {
+        return ConstIterator(*this, kSlotsCount);
+    }
+
+private:
+    struct WindowProbeResult
+    {
+        // Index of the slot with the key
+        size_t key_index = kInvalidIndex;
+
+        // First slot in the window that can take a new key
+        size_t free_index = kInvalidIndex;
+
+        // True if the window has a slot that was never used, i.e. the key can't be in the stash
+        bool hit_unused_slot = false;
+    };
+
+    constexpr WindowProbeResult ProbeWindow(const Key& key) const
+    {
+        WindowProbeResult result{};
+        ProbeSequence probe(Hasher{}(key));
+        for (size_t probe_index = 0; probe_index != max_probes; ++probe_index, probe.Next())
+        {
+            const size_t index = probe.GetIndex();
+            if (has_index_.Get(index))
+            {
+                if (keys_[index] == key)
+                {
+                    result.key_index = index;
+                    return result;
+                }
+            }
+            else
+            {
+                if (result.free_index == kInvalidIndex)
+                {
+                    result.free_index = index;
+                }
+
+                if (!was_deleted_.Get(index))
+                {
+                    result.hit_unused_slot = true;
+                    return result;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    struct StashScanResult
+    {
+        size_t key_index = kInvalidIndex;
+        size_t free_index = kInvalidIndex;
+    };
+
+    // Compares the key with every stash slot without looking at the occupancy bitset,
+    // occupancy is applied afterwards with a single mask.
+    constexpr StashScanResult ScanStash(const Key& key) const
+    {
+        auto matches = bounded_fixed_unordered_map_detail::MatchKeys<StashMask, stash_capacity>(
+            keys_.data() + capacity,  // NOLINT
+            key);
+        matches &= stash_occupancy_;
+
+        StashScanResult result{};
+        if (matches != 0)
+        {
+            result.key_index = capacity + static_cast<size_t>(std::countr_zero(matches));
+        }
+
+        if (const auto free = static_cast<StashMask>(~stash_occupancy_ & kStashMask); free != 0)
+        {
+            result.free_index = capacity + static_cast<size_t>(std::countr_zero(free));
+        }
+
+        return result;
+    }
+
+    // Keeps the stash occupancy word in sync with has_index_
+    constexpr bool SetOccupied(const size_t index, const bool value)
+    {
+        if (index >= capacity)
+        {
+            const auto bit = static_cast<StashMask>(StashMask{1} << (index - capacity));
+            stash_occupancy_ = static_cast<StashMask>(value ? (stash_occupancy_ | bit) : (stash_occupancy_ & ~bit));
+        }
+
+        return has_index_.Set(index, value);
+    }
+
+    constexpr size_t FindKeyIndex(const Key& key) const
+    {
+        const WindowProbeResult window = ProbeWindow(key);
+        if (window.key_index != kInvalidIndex)
+        {
+            return window.key_index;
+        }
+
+        if (window.hit_unused_slot)
+        {
+            return kInvalidIndex;
+        }
+
+        return ScanStash(key).key_index;
+    }
+
+    // Returns the slot that holds the key or the slot where it should be placed
+    constexpr size_t FindSlotForKey(const Key& key) const
+    {
+        const WindowProbeResult window = ProbeWindow(key);
+        if (window.key_index != kInvalidIndex)
+        {
+            return window.key_index;
+        }
+
+        if (window.hit_unused_slot)
+        {
+            return window.free_index;
+        }
+
+        // Window was full at some point - the key might have been moved to the stash.
+        // One pass over the stash finds both the key and a free slot for it.
+        const StashScanResult stash = ScanStash(key);
+        if (stash.key_index != kInvalidIndex)
+        {
+            return stash.key_index;
+        }
+
+        if (window.free_index != kInvalidIndex)
+        {
+            return window.free_index;
+        }
+
+        return stash.free_index;
+    }
+
+    constexpr size_t GetFirstIndexWithValue() const noexcept
+    {
+        return has_index_.FindNextSet();
+    }
+
+    constexpr size_t GetNextIndexWithValue(size_t prev_index) const noexcept
+    {
+        assert(prev_index <= kSlotsCount);
+        return has_index_.FindNextSet(prev_index + 1);
+    }
+
+    constexpr const Key& GetKeyAt(size_t index) const noexcept
+    {
+        return keys_[index];
+    }
+
+    constexpr Value& GetValueAt(size_t index) noexcept
+    {
+        return values_[index];
+    }
+
+    constexpr const Value& GetValueAt(size_t index) const noexcept
+    {
+        return values_[index];
+    }
+
+private:
+    using StashMask = BitsCountToUnsignedIntT<fixed_bitset_detail::GetOptimalPartSize(stash_capacity)>;
+    static constexpr auto kStashMask =
+        static_cast<StashMask>(static_cast<StashMask>(~StashMask{0}) >> (sizeof(StashMask) * 8 - stash_capacity));
+
+    using OccupancyBits =
+        std::conditional_t<cached_size, CountedBits<FixedBitset<kSlotsCount>>, FixedBitset<kSlotsCount>>;
+
+    std::array<Key, kSlotsCount> keys_{};
+    std::array<Value, kSlotsCount> values_{};
+    OccupancyBits has_index_{};
+    FixedBitset<kSlotsCount> was_deleted_{};
+    StashMask stash_occupancy_ = 0;
+};
+}  // namespace ass
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "bit/bit_expression.hpp"
+#include "bit/bit_part.hpp"
+#include "bit_span.hpp"
+#include "fixed_bitset.hpp"
+
+namespace ass
+{
+// FixedBitset or modifiable BitSpan that keeps the number of set bits up to date.
+// CountOnes, Any, None and All are O(1). Set already knows whether the bit flipped, range operations
+// count the affected range before changing it and expression assignment counts parts while writing them.
+// Bits must not be modified bypassing this wrapper (e.g. through another BitSpan over the same memory).
+template <typename Bits>
+class CountedBits
+{
+public:
+    constexpr CountedBits() = default;
+
+    constexpr explicit CountedBits(const Bits& bits) : bits_(bits), count_(bits_.CountOnes()) {}
+
+    template <bit_expression Expression>
+    constexpr CountedBits(const Expression& expression)  // NOLINT
+        requires(std::is_default_constructible_v<Bits>)
+    {
+        *this = expression;
+    }
+
+    // Evaluates the expression and counts ones in the same pass. Bits past the size are preserved.
+    template <bit_expression Expression>
+    constexpr CountedBits& operator=(const Expression& expression)
+    {
+        using Part = typename Expression::Part;
+        constexpr size_t bits_per_part = sizeof(Part) * 8;
+        assert(expression.GetSize() == GetSize());
+
+        count_ = 0;
+        const size_t parts_count = expression.GetPartsCount();
+        for (size_t part_index = 0; part_index != parts_count; ++part_index)
+        {
+            const Part value = expression.GetMaskedPart(part_index);
+            count_ += static_cast<size_t>(bit_part_detail::PopCount(value));
+
+            Part& part = GetMutablePart(part_index);
+            const size_t used_bits = GetSize() - part_index * bits_per_part;
+            if (used_bits >= bits_per_part)
+            {
+                part = value;
+            }
+            else
+            {
+                const Part used_mask = static_cast<Part>(~(std::numeric_limits<Part>::max() << used_bits));
+                part = static_cast<Part>(value | (part & ~used_mask));
+            }
+        }
+        return *this;
+    }
+
+    [[nodiscard]] friend constexpr auto ToBitExpression(const CountedBits& bits) noexcept
+    {
+        return ToBitExpression(bits.bits_);
+    }
+
+    [[nodiscard]] constexpr const Bits& GetBits() const noexcept
+    {
+        return bits_;
+    }
+
+    [[nodiscard]] constexpr size_t GetSize() const noexcept
+    {
+        return ToBitExpression(bits_).GetSize();
+    }
+
+    [[nodiscard]] constexpr bool Get(const size_t index) const
+    {
+        return bits_.Get(index);
+    }
+
+    // Returns true if bit at specified index was flipped
+    constexpr bool Set(const size_t index, const bool value)
+    {
+        if (bits_.Get(index) == value) return false;
+
+        bits_.Set(index, value);
+        if (value)
+        {
+            ++count_;
+        }
+        else
+        {
+            --count_;
+        }
+        return true;
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes() const noexcept
+    {
+        return count_;
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes(const size_t begin, const size_t end) const
+    {
+        return bits_.CountOnes(begin, end);
+    }
+
+    [[nodiscard]] constexpr bool Any() const noexcept
+    {
+        return count_ != 0;
+    }
+
+    [[nodiscard]] constexpr bool None() const noexcept
+    {
+        return count_ == 0;
+    }
+
+    [[nodiscard]] constexpr bool All() const noexcept
+    {
+        return count_ == GetSize();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr bool Intersects(const Operand& another) const noexcept
+    {
+        return bits_.Intersects(another);
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr bool IsSubsetOf(const Operand& another) const noexcept
+    {
+        return bits_.IsSubsetOf(another);
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t AndCount(const Operand& another) const noexcept
+    {
+        return bits_.AndCount(another);
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t OrCount(const Operand& another) const noexcept
+    {
+        return count_ + ToBitExpression(another).CountOnes() - bits_.AndCount(another);
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t XorCount(const Operand& another) const noexcept
+    {
+        return count_ + ToBitExpression(another).CountOnes() - 2 * bits_.AndCount(another);
+    }
+
+    constexpr void SetRange(const size_t begin, const size_t end)
+    {
+        count_ += (end - begin) - bits_.CountOnes(begin, end);
+        bits_.SetRange(begin, end);
+    }
+
+    constexpr void ResetRange(const size_t begin, const size_t end)
+    {
+        count_ -= bits_.CountOnes(begin, end);
+        bits_.ResetRange(begin, end);
+    }
+
+    constexpr void FlipRange(const size_t begin, const size_t end)
+    {
+        count_ += (end - begin) - 2 * bits_.CountOnes(begin, end);
+        bits_.FlipRange(begin, end);
+    }
+
+    constexpr void Fill(const bool value)
+    {
+        if (value)
+        {
+            SetRange(0, GetSize());
+        }
+        else
+        {
+            ResetRange(0, GetSize());
+        }
+    }
+
+    constexpr void Flip()
+    {
+        bits_.Flip();
+        count_ = GetSize() - count_;
+    }
+
+    // Only the bits that stay are counted, vacated bits are zeros
+    constexpr void ShiftLeft(size_t shift)
+    {
+        const size_t size = GetSize();
+        shift = std::min(shift, size);
+        count_ = bits_.CountOnes(0, size - shift);
+        if constexpr (bit_span_detail::is_bit_span<Bits>)
+        {
+            bits_.ShiftLeft(shift);
+        }
+        else
+        {
+            bits_ <<= shift;
+        }
+    }
+
+    constexpr void ShiftRight(size_t shift)
+    {
+        const size_t size = GetSize();
+        shift = std::min(shift, size);
+        count_ = bits_.CountOnes(shift, size);
+        if constexpr (bit_span_detail::is_bit_span<Bits>)
+        {
+            bits_.ShiftRight(shift);
+        }
+        else
+        {
+            bits_ >>= shift;
+        }
+    }
+
+    // Rotations do not change the count
+    constexpr void RotateLeft(const size_t shift)
+    {
+        bits_.RotateLeft(shift);
+    }
+
+    constexpr void RotateRight(const size_t shift)
+    {
+        bits_.RotateRight(shift);
+    }
+
+    [[nodiscard]] constexpr size_t FindNextSet(const size_t from_index = 0) const noexcept
+    {
+        return bits_.FindNextSet(from_index);
+    }
+
+    [[nodiscard]] constexpr size_t FindNextZero(const size_t from_index = 0) const noexcept
+    {
+        return bits_.FindNextZero(from_index);
+    }
+
+    [[nodiscard]] constexpr size_t FindPrevSet(const size_t from_index = std::numeric_limits<size_t>::max()) const
+        noexcept
+    {
+        return bits_.FindPrevSet(from_index);
+    }
+
+    template <typename F>
+    constexpr void ForEachSetBit(F&& f) const
+    {
+        bits_.ForEachSetBit(std::forward<F>(f));
+    }
+
+private:
+    [[nodiscard]] constexpr auto& GetMutablePart(const size_t part_index) noexcept
+    {
+        if constexpr (bit_span_detail::is_bit_span<Bits>)
+        {
+            return bits_.GetPart(part_index);
+        }
+        else
+        {
+            return bits_.GetParts()[part_index];
+        }
+    }
+
+private:
+    Bits bits_{};
+    size_t count_ = 0;
+};
+}  // namespace ass
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <utility>
+
+#include "bit/bit_expression.hpp"
+#include "bit/bit_part.hpp"
+#include "bit_span.hpp"
+
+namespace ass::dynamic_bitset_detail
+{
+// Heap storage starts at a cache line (and so at a vector of any SIMD width)
+inline constexpr size_t kHeapAlignment = 64;
+}  // namespace ass::dynamic_bitset_detail
+
+namespace ass
+{
+// Owning bitset with the size chosen at runtime.
+// Up to kInlinePartsCount parts are stored inside the object, larger bitsets live on the heap in aligned storage
+// that grows geometrically. All the work is done by BitSpan views (GetSpan), so bulk operations use the same
+// SIMD kernels and lazy expressions as any other span. Bits past the size are always zeros.
+template <bit_part Part = uint64_t, size_t kInlinePartsCount = 2>
+class DynamicBitset
+{
+    static constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+
+public:
+    DynamicBitset() = default;
+
+    explicit DynamicBitset(const size_t size, const bool value = false)
+    {
+        Resize(size, value);
+    }
+
+    DynamicBitset(const DynamicBitset& another)
+    {
+        *this = another;
+    }
+
+    DynamicBitset(DynamicBitset&& another) noexcept
+    {
+        *this = std::move(another);
+    }
+
+    ~DynamicBitset()
+    {
+        FreeHeap();
+    }
+
+    DynamicBitset& operator=(const DynamicBitset& another)
+    {
+        if (this == &another) return *this;
+
+        Clear();
+        const size_t parts_count = GetPartsCount(another.size_);
+        if (parts_count > capacity_) Reallocate(parts_count);
+        std::copy_n(another.GetData(), parts_count, GetData());
+        size_ = another.size_;
+        return *this;
+    }
+
+    DynamicBitset& operator=(DynamicBitset&& another) noexcept
+    {
+        if (this == &another) return *this;
+
+        FreeHeap();
+        if (another.heap_parts_)
+        {
+            heap_parts_ = std::exchange(another.heap_parts_, nullptr);
+            capacity_ = std::exchange(another.capacity_, kInlinePartsCount);
+            inline_parts_.fill(0);
+        }
+        else
+        {
+            inline_parts_ = another.inline_parts_;
+            another.inline_parts_.fill(0);
+        }
+        size_ = std::exchange(another.size_, 0);
+        return *this;
+    }
+
+    // Evaluates lazy expression (see bit/bit_expression.hpp) of the same size in one pass
+    template <bit_expression Expression>
+    DynamicBitset& operator=(const Expression& expression)
+    {
+        GetSpan().Assign(expression);
+        return *this;
+    }
+
+    [[nodiscard]] friend auto ToBitExpression(const DynamicBitset& bitset) noexcept
+    {
+        return ToBitExpression(bitset.GetSpan());
+    }
+
+    [[nodiscard]] friend bool operator==(const DynamicBitset& a, const DynamicBitset& b) noexcept
+    {
+        return a.size_ == b.size_ && std::equal(a.GetData(), a.GetData() + GetPartsCount(a.size_), b.GetData());
+    }
+
+    [[nodiscard]] size_t GetSize() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    // Number of bits that fit without reallocation
+    [[nodiscard]] size_t GetCapacity() const noexcept
+    {
+        return capacity_ * kBitsPerPart;
+    }
+
+    [[nodiscard]] bool IsInline() const noexcept
+    {
+        return heap_parts_ == nullptr;
+    }
+
+    void Reserve(const size_t size)
+    {
+        const size_t parts_count = GetPartsCount(size);
+        if (parts_count > capacity_) Reallocate(parts_count);
+    }
+
+    // New bits get the specified value
+    void Resize(const size_t size, const bool value = false)
+    {
+        const size_t old_size = size_;
+        const size_t parts_count = GetPartsCount(size);
+        if (parts_count > capacity_)
+        {
+            Reallocate(std::max(parts_count, 2 * capacity_));
+        }
+
+        if (size < old_size)
+        {
+            // Keep bits past the size zeroed
+            GetSpan().ResetRange(size, old_size);
+        }
+
+        size_ = size;
+        if (value && size > old_size)
+        {
+            GetSpan().SetRange(old_size, size);
+        }
+    }
+
+    void Clear() noexcept
+    {
+        std::fill_n(GetData(), GetPartsCount(size_), Part{0});
+        size_ = 0;
+    }
+
+    // Releases the heap storage if the bits fit into the inline storage or into a smaller allocation
+    void ShrinkToFit()
+    {
+        if (!IsInline() && GetPartsCount(size_) < capacity_) Reallocate(GetPartsCount(size_));
+    }
+
+    [[nodiscard]] BitSpan<Part> GetSpan() noexcept
+    {
+        return BitSpan<Part>(GetData(), {.parts_count = GetPartsCount(size_), .size = size_});
+    }
+
+    [[nodiscard]] BitSpan<const Part> GetSpan() const noexcept
+    {
+        return BitSpan<const Part>(GetData(), {.parts_count = GetPartsCount(size_), .size = size_});
+    }
+
+    [[nodiscard]] std::span<Part> GetParts() noexcept
+    {
+        return {GetData(), GetPartsCount(size_)};
+    }
+
+    [[nodiscard]] std::span<const Part> GetParts() const noexcept
+    {
+        return {GetData(), GetPartsCount(size_)};
+    }
+
+    [[nodiscard]] bool Get(const size_t index) const
+    {
+        return GetSpan().Get(index);
+    }
+
+    void Set(const size_t index, const bool value)
+    {
+        GetSpan().Set(index, value);
+    }
+
+    // Appends a bit to the end, amortized O(1)
+    void PushBack(const bool value)
+    {
+        Resize(size_ + 1);
+        if (value) Set(size_ - 1, true);
+    }
+
+    [[nodiscard]] size_t CountOnes() const
+    {
+        return GetSpan().CountOnes();
+    }
+
+    [[nodiscard]] bool Any() const noexcept
+    {
+        return GetSpan().Any();
+    }
+
+    [[nodiscard]] bool None() const noexcept
+    {
+        return GetSpan().None();
+    }
+
+    [[nodiscard]] bool All() const noexcept
+    {
+        return GetSpan().All();
+    }
+
+private:
+    [[nodiscard]] static constexpr size_t GetPartsCount(const size_t size) noexcept
+    {
+        return (size + kBitsPerPart - 1) / kBitsPerPart;
+    }
+
+    [[nodiscard]] Part* GetData() noexcept
+    {
+        return heap_parts_ ? heap_parts_ : inline_parts_.data();
+    }
+
+    [[nodiscard]] const Part* GetData() const noexcept
+    {
+        return heap_parts_ ? heap_parts_ : inline_parts_.data();
+    }
+
+    [[nodiscard]] static Part* AllocateHeap(const size_t parts_count)
+    {
+        void* memory = ::operator new(
+            parts_count * sizeof(Part),
+            std::align_val_t{dynamic_bitset_detail::kHeapAlignment});
+        return static_cast<Part*>(memory);
+    }
+
+    void FreeHeap() noexcept
+    {
+        if (!heap_parts_) return;
+
+        ::operator delete(heap_parts_, std::align_val_t{dynamic_bitset_detail::kHeapAlignment});
+        heap_parts_ = nullptr;
+        capacity_ = kInlinePartsCount;
+    }
+
+    // Moves current parts to storage for exactly `capacity` parts (or to the inline storage if they fit).
+    // Parts past the current ones are zeroed. Inline parts are kept zeroed while the heap is used.
+    void Reallocate(const size_t capacity)
+    {
+        const size_t parts_count = std::min(GetPartsCount(size_), capacity);
+        if (capacity <= kInlinePartsCount)
+        {
+            if (IsInline()) return;
+
+            std::array<Part, kInlinePartsCount> parts{};
+            std::copy_n(heap_parts_, parts_count, parts.begin());
+            FreeHeap();
+            inline_parts_ = parts;
+            return;
+        }
+
+        Part* heap_parts = AllocateHeap(capacity);
+        std::copy_n(GetData(), parts_count, heap_parts);
+        std::fill(heap_parts + parts_count, heap_parts + capacity, Part{0});
+        FreeHeap();
+        inline_parts_.fill(0);
+        heap_parts_ = heap_parts;
+        capacity_ = capacity;
+    }
+
+private:
+    std::array<Part, kInlinePartsCount> inline_parts_{};
+    Part* heap_parts_ = nullptr;
+    size_t capacity_ = kInlinePartsCount;
+    size_t size_ = 0;
+};
+}  // namespace ass
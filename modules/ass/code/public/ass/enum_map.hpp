@@ -33,7 +33,7 @@ public:
 
     constexpr EnumMapIterator& operator++() noexcept
     {
-        index_ = map_->keys_.GetBitset().CountContinuousZeroBits(index_ + 1);
+        index_ = map_->keys_.GetBitset().FindNextSet(index_ + 1);
         return *this;
     }
 
@@ -198,7 +198,7 @@ private:
     template <typename It, typename This>
     static constexpr It MakeBegin(This this_) noexcept
     {
-        return It(*this_, this_->keys_.GetBitset().CountContinuousZeroBits());
+        return It(*this_, this_->keys_.GetBitset().FindNextSet());
     }
 
     template <typename It, typename This>
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstddef>
+#include <type_traits>
 
+#include "counted_bits.hpp"
 #include "enum/enum_as_index.hpp"
 #include "fixed_bitset.hpp"
 
@@ -15,7 +17,8 @@ class EnumSetIterator;
 // It works for types that implement EnumIndexConverter from bit/enum_as_index.hpp.
 // An advantage here is that this set does not require heap allocations because
 // it knows the number of possible values and can create an appropriate bitset for them.
-template <typename T, typename Converter = EnumIndexConverter<T>>
+// Pass cached_size = true to keep the number of values in a counter so Size() does not scan the bitset.
+template <typename T, typename Converter = EnumIndexConverter<T>, bool cached_size = false>
 class EnumSet
 {
 public:
@@ -24,6 +27,27 @@ public:
     using EnumConverter = Converter;
     friend Iterator;
 
+    constexpr EnumSet() = default;
+
+    // Evaluates lazy expression of enum sets like `Lazy(a) & ~Lazy(b) | c` in one pass (see bit/bit_expression.hpp)
+    template <bit_expression Expression>
+    constexpr EnumSet(const Expression& expression)  // NOLINT
+        : bits_(expression)
+    {
+    }
+
+    template <bit_expression Expression>
+    constexpr EnumSet& operator=(const Expression& expression)
+    {
+        bits_ = expression;
+        return *this;
+    }
+
+    [[nodiscard]] friend constexpr auto ToBitExpression(const EnumSet& set) noexcept
+    {
+        return ToBitExpression(set.bits_);
+    }
+
     // Adds new value to the set.
     // Returns true if new value was actually added.
     // Returns false if values was already there.
@@ -49,9 +73,7 @@ public:
 
     constexpr const EnumSet GetComplement() const
     {
-        auto copy = *this;
-        copy.bits_ = ~copy.bits_;
-        return copy;
+        return ~Lazy(bits_);
     }
 
     // Replaces this set with complement to self
@@ -73,21 +95,52 @@ public:
 
     constexpr bool IsEmpty() const
     {
-        return Size() == 0;
+        return bits_.None();
+    }
+
+    // Returns true if the set contains all possible values
+    constexpr bool IsFull() const
+    {
+        return bits_.All();
+    }
+
+    // Queries below do not build intermediate sets and stop as soon as the answer is known
+
+    constexpr bool Intersects(const EnumSet& another) const
+    {
+        return bits_.Intersects(another.bits_);
+    }
+
+    constexpr bool IsSubsetOf(const EnumSet& another) const
+    {
+        return bits_.IsSubsetOf(another.bits_);
+    }
+
+    constexpr size_t IntersectionSize(const EnumSet& another) const
+    {
+        return bits_.AndCount(another.bits_);
+    }
+
+    constexpr size_t UnionSize(const EnumSet& another) const
+    {
+        return bits_.OrCount(another.bits_);
+    }
+
+    constexpr size_t SymmetricDifferenceSize(const EnumSet& another) const
+    {
+        return bits_.XorCount(another.bits_);
     }
 
     // {A, B, C} - {A, C} -> {B}.
     // {A, C} - {A, B, C} -> {}.
     constexpr EnumSet GetDifferenceFrom(const EnumSet& another) const
     {
-        return GetIntersectionWith(another.GetComplement());
+        return Lazy(bits_) & ~Lazy(another.bits_);
     }
 
     constexpr EnumSet GetIntersectionWith(const EnumSet& another) const
     {
-        auto copy = *this;
-        copy.bits_ &= another.bits_;
-        return copy;
+        return Lazy(bits_) & another.bits_;
     }
 
     constexpr EnumSet operator-(const EnumSet& another) const
@@ -95,9 +148,36 @@ public:
         return GetDifferenceFrom(another);
     }
 
+    constexpr EnumSet operator~() const
+    {
+        return GetComplement();
+    }
+
+    constexpr EnumSet operator&(const EnumSet& another) const
+    {
+        return GetIntersectionWith(another);
+    }
+
+    constexpr EnumSet operator|(const EnumSet& another) const
+    {
+        return Lazy(bits_) | another.bits_;
+    }
+
+    constexpr EnumSet operator^(const EnumSet& another) const
+    {
+        return Lazy(bits_) ^ another.bits_;
+    }
+
     constexpr const auto& GetBitset() const
     {
-        return bits_;
+        if constexpr (cached_size)
+        {
+            return bits_.GetBits();
+        }
+        else
+        {
+            return bits_;
+        }
     }
 
     [[nodiscard]] static constexpr EnumSet Full()
@@ -109,14 +189,17 @@ public:
 
     // clang-format off
     // STL
-    auto begin() const { return Iterator(*this, bits_.CountContinuousZeroBits()); }
+    auto begin() const { return Iterator(*this, bits_.FindNextSet()); }
     auto end() const { return Iterator(*this, kCapacity); }
 
     // clang-format on
 
 private:
     static constexpr size_t kCapacity = Converter::GetElementsCount();
-    FixedBitset<kCapacity> bits_{};
+
+    using Bits = std::conditional_t<cached_size, CountedBits<FixedBitset<kCapacity>>, FixedBitset<kCapacity>>;
+
+    Bits bits_{};
 };
 
 template <typename Collection>
@@ -130,7 +213,7 @@ public:
 
     constexpr EnumSetIterator& operator++()
     {
-        index_ = set_->bits_.CountContinuousZeroBits(index_ + 1);
+        index_ = set_->bits_.FindNextSet(index_ + 1);
         return *this;
     }
 
@@ -0,0 +1,499 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bit_span.hpp"
+
+namespace ass::ewah_bitmap_detail
+{
+inline constexpr size_t kBitsPerWord = 64;
+inline constexpr uint64_t kAllOnes = ~uint64_t{0};
+
+// Marker word layout: bit 0 is the value of clean words, the next 32 bits count clean words
+// and the top 31 bits count literal words stored right after the marker
+inline constexpr size_t kRunLengthBits = 32;
+inline constexpr size_t kLiteralsCountBits = 31;
+inline constexpr size_t kMaxRunLength = (size_t{1} << kRunLengthBits) - 1;
+inline constexpr size_t kMaxLiteralsCount = (size_t{1} << kLiteralsCountBits) - 1;
+
+struct Marker
+{
+    bool run_bit = false;
+    size_t run_length = 0;
+    size_t literals_count = 0;
+};
+
+[[nodiscard]] constexpr uint64_t PackMarker(const Marker& marker) noexcept
+{
+    return uint64_t{marker.run_bit} | (uint64_t{marker.run_length} << 1) |
+           (uint64_t{marker.literals_count} << (kRunLengthBits + 1));
+}
+
+[[nodiscard]] constexpr Marker UnpackMarker(const uint64_t word) noexcept
+{
+    return {
+        .run_bit = (word & 1) != 0,
+        .run_length = static_cast<size_t>((word >> 1) & kMaxRunLength),
+        .literals_count = static_cast<size_t>(word >> (kRunLengthBits + 1))};
+}
+
+enum class Operation : uint8_t
+{
+    kAnd,
+    kOr,
+    kXor
+};
+
+template <Operation operation>
+[[nodiscard]] constexpr uint64_t Apply(const uint64_t a, const uint64_t b) noexcept
+{
+    if constexpr (operation == Operation::kAnd) return a & b;
+    if constexpr (operation == Operation::kOr) return a | b;
+    if constexpr (operation == Operation::kXor) return a ^ b;
+}
+}  // namespace ass::ewah_bitmap_detail
+
+namespace ass
+{
+// Streaming decoder of EWAH words (see EwahBitmap). Keeps a few counters of state and reads the words front to back
+// exactly once, so the input may be any buffer: a memory mapped file or a block received from the network.
+// Doubles as a cursor for merging compressed streams: the current position is either inside a run of clean words
+// or at a literal word. A marker that promises more literal words than are left ends decoding and marks the reader
+// as corrupted.
+class EwahReader
+{
+public:
+    EwahReader() = default;
+
+    explicit EwahReader(const std::span<const uint64_t> words) noexcept : words_(words)
+    {
+        Normalize();
+    }
+
+    // All words are decoded
+    [[nodiscard]] bool IsDone() const noexcept
+    {
+        return run_length_ == 0 && literals_count_ == 0;
+    }
+
+    // Decoding stopped at a marker that does not fit the words
+    [[nodiscard]] bool IsCorrupted() const noexcept
+    {
+        return corrupted_;
+    }
+
+    [[nodiscard]] bool IsInRun() const noexcept
+    {
+        return run_length_ != 0;
+    }
+
+    [[nodiscard]] bool GetRunBit() const noexcept
+    {
+        assert(IsInRun());
+        return run_bit_;
+    }
+
+    // Clean words left in the current run
+    [[nodiscard]] size_t GetRunLength() const noexcept
+    {
+        return run_length_;
+    }
+
+    // Literal words left after the current run is over
+    [[nodiscard]] std::span<const uint64_t> GetLiterals() const noexcept
+    {
+        return words_.subspan(position_, literals_count_);
+    }
+
+    [[nodiscard]] uint64_t GetLiteral() const noexcept
+    {
+        assert(!IsInRun() && !IsDone());
+        return words_[position_];
+    }
+
+    // Skips `words_count` decoded words, whole runs are skipped in O(1)
+    void Skip(size_t words_count) noexcept
+    {
+        while (words_count != 0)
+        {
+            assert(!IsDone());
+            if (run_length_ != 0)
+            {
+                const size_t n = std::min(words_count, run_length_);
+                run_length_ -= n;
+                words_count -= n;
+            }
+            else
+            {
+                const size_t n = std::min(words_count, literals_count_);
+                position_ += n;
+                literals_count_ -= n;
+                words_count -= n;
+            }
+            Normalize();
+        }
+    }
+
+    // Decodes up to `out.size()` words, returns the number of decoded words
+    size_t ReadWords(const std::span<uint64_t> out) noexcept
+    {
+        size_t count = 0;
+        while (count != out.size() && !IsDone())
+        {
+            size_t n = 0;
+            if (run_length_ != 0)
+            {
+                n = std::min(out.size() - count, run_length_);
+                const uint64_t word = run_bit_ ? ewah_bitmap_detail::kAllOnes : 0;
+                std::fill_n(out.begin() + static_cast<ptrdiff_t>(count), n, word);
+                run_length_ -= n;
+            }
+            else
+            {
+                n = std::min(out.size() - count, literals_count_);
+                std::copy_n(GetLiterals().begin(), n, out.begin() + static_cast<ptrdiff_t>(count));
+                position_ += n;
+                literals_count_ -= n;
+            }
+            count += n;
+            Normalize();
+        }
+        return count;
+    }
+
+    // Decodes the next `chunk.GetSize()` bits into the chunk.
+    // All chunks but the last one must be a whole number of words, bits past the chunk size are kept.
+    template <std::unsigned_integral Part, BitSpanStaticExtents extents>
+    void Read(const BitSpan<Part, extents>& chunk) noexcept
+        requires(BitSpan<Part, extents>::kCanModifyData && std::same_as<Part, uint64_t>)
+    {
+        constexpr size_t bits_per_word = ewah_bitmap_detail::kBitsPerWord;
+        const size_t size = chunk.GetSize();
+        if (size == 0) return;
+
+        const size_t full_words_count = size / bits_per_word;
+        [[maybe_unused]] const size_t read_count = ReadWords({&chunk.GetPart(0), full_words_count});
+        assert(read_count == full_words_count);
+
+        if (const size_t tail_size = size % bits_per_word; tail_size != 0)
+        {
+            uint64_t word = 0;
+            [[maybe_unused]] const size_t tail_read_count = ReadWords({&word, 1});
+            assert(tail_read_count == 1);
+
+            const uint64_t mask = (uint64_t{1} << tail_size) - 1;
+            uint64_t& part = chunk.GetPart(full_words_count);
+            part = (part & ~mask) | (word & mask);
+        }
+    }
+
+private:
+    // Loads markers until there is something to decode or the words are over
+    void Normalize() noexcept
+    {
+        while (run_length_ == 0 && literals_count_ == 0 && position_ < words_.size())
+        {
+            const auto marker = ewah_bitmap_detail::UnpackMarker(words_[position_++]);
+            if (marker.literals_count > words_.size() - position_)
+            {
+                corrupted_ = true;
+                position_ = words_.size();
+                return;
+            }
+
+            run_bit_ = marker.run_bit;
+            run_length_ = marker.run_length;
+            literals_count_ = marker.literals_count;
+        }
+    }
+
+private:
+    std::span<const uint64_t> words_;
+    size_t position_ = 0;
+    bool run_bit_ = false;
+    size_t run_length_ = 0;
+    size_t literals_count_ = 0;
+    bool corrupted_ = false;
+};
+
+// Bitmap compressed with Enhanced Word-Aligned Hybrid scheme: 64-bit words where runs of all-zero or all-one
+// words collapse into a marker word that also counts the dirty (literal) words stored verbatim after it.
+// Long runs of equal bits take a single word, random bits cost one extra word per 2^31 literals.
+// Bits are appended from BitSpan chunks and decoded by EwahReader into chunks, so neither side needs
+// the whole uncompressed bitmap in memory. Logical operations merge two compressed streams run by run:
+// a clean run of one operand either decides the result or copies the other operand, without decoding it.
+// Bits past the size in the last word are always zeros.
+class EwahBitmap
+{
+    static constexpr size_t kBitsPerWord = ewah_bitmap_detail::kBitsPerWord;
+
+public:
+    EwahBitmap() = default;
+
+    // Adopts words of a bitmap with `size` bits produced by GetWords (e.g. loaded from a file).
+    // The words are untrusted: returns nullopt if a marker promises more literal words than are left,
+    // if the words do not decode to exactly ceil(size / 64) words or if bits past the size are set.
+    [[nodiscard]] static std::optional<EwahBitmap> FromWords(std::vector<uint64_t> words, const size_t size)
+    {
+        EwahBitmap r;
+        r.words_ = std::move(words);
+        r.size_ = size;
+
+        // Appending continues from the last marker
+        size_t decoded_count = 0;
+        uint64_t last_word = 0;
+        for (size_t position = 0; position < r.words_.size();)
+        {
+            const auto marker = ewah_bitmap_detail::UnpackMarker(r.words_[position]);
+            if (marker.literals_count > r.words_.size() - position - 1) return std::nullopt;
+
+            r.marker_position_ = position;
+            r.marker_ = marker;
+            position += 1 + marker.literals_count;
+            decoded_count += marker.run_length + marker.literals_count;
+            if (marker.literals_count != 0)
+            {
+                last_word = r.words_[position - 1];
+            }
+            else if (marker.run_length != 0)
+            {
+                last_word = marker.run_bit ? ewah_bitmap_detail::kAllOnes : 0;
+            }
+        }
+
+        if (decoded_count != (size + kBitsPerWord - 1) / kBitsPerWord) return std::nullopt;
+        if (const size_t tail_size = size % kBitsPerWord; tail_size != 0 && (last_word >> tail_size) != 0)
+        {
+            return std::nullopt;
+        }
+
+        return r;
+    }
+
+    // Streaming encoder: appends bits of the chunk to the end.
+    // All chunks but the last one must be a whole number of words.
+    template <std::unsigned_integral Part, BitSpanStaticExtents extents>
+    void Append(const BitSpan<Part, extents>& chunk)
+        requires(std::same_as<std::remove_const_t<Part>, uint64_t>)
+    {
+        assert(size_ % kBitsPerWord == 0);
+        const size_t size = chunk.GetSize();
+        const size_t full_words_count = size / kBitsPerWord;
+        for (size_t word_index = 0; word_index != full_words_count; ++word_index)
+        {
+            AppendWord(chunk.GetPart(word_index));
+        }
+
+        if (const size_t tail_size = size % kBitsPerWord; tail_size != 0)
+        {
+            AppendWord(chunk.GetPart(full_words_count) & ((uint64_t{1} << tail_size) - 1));
+        }
+        size_ += size;
+    }
+
+    // Appends `bits_count` bits with the specified value in O(1) words
+    void AppendFill(const bool value, const size_t bits_count)
+    {
+        assert(size_ % kBitsPerWord == 0);
+        AppendRun(value, bits_count / kBitsPerWord);
+        if (const size_t tail_size = bits_count % kBitsPerWord; tail_size != 0)
+        {
+            AppendWord(value ? (uint64_t{1} << tail_size) - 1 : 0);
+        }
+        size_ += bits_count;
+    }
+
+    [[nodiscard]] EwahReader GetReader() const noexcept
+    {
+        return EwahReader(words_);
+    }
+
+    // Number of bits
+    [[nodiscard]] size_t GetSize() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    // Compressed representation, together with the size it is all FromWords needs
+    [[nodiscard]] std::span<const uint64_t> GetWords() const noexcept
+    {
+        return words_;
+    }
+
+    [[nodiscard]] size_t GetSizeInBytes() const noexcept
+    {
+        return words_.size() * sizeof(uint64_t);
+    }
+
+    // Runs are counted without decoding
+    [[nodiscard]] size_t CountOnes() const noexcept
+    {
+        size_t n = 0;
+        for (EwahReader reader = GetReader(); !reader.IsDone();)
+        {
+            if (reader.IsInRun())
+            {
+                if (reader.GetRunBit()) n += reader.GetRunLength() * kBitsPerWord;
+                reader.Skip(reader.GetRunLength());
+            }
+            else
+            {
+                const auto literals = reader.GetLiterals();
+                for (const uint64_t literal : literals) n += static_cast<size_t>(std::popcount(literal));
+                reader.Skip(literals.size());
+            }
+        }
+        return n;
+    }
+
+    [[nodiscard]] friend EwahBitmap operator&(const EwahBitmap& a, const EwahBitmap& b)
+    {
+        return Merge<ewah_bitmap_detail::Operation::kAnd>(a, b);
+    }
+
+    [[nodiscard]] friend EwahBitmap operator|(const EwahBitmap& a, const EwahBitmap& b)
+    {
+        return Merge<ewah_bitmap_detail::Operation::kOr>(a, b);
+    }
+
+    [[nodiscard]] friend EwahBitmap operator^(const EwahBitmap& a, const EwahBitmap& b)
+    {
+        return Merge<ewah_bitmap_detail::Operation::kXor>(a, b);
+    }
+
+private:
+    // Both operands are read once and the result is encoded as it is produced.
+    // Whenever one of the operands is in a clean run, the whole run is processed at once:
+    // it absorbs the other operand (x & 0, x | 1) or passes it through, negated for x ^ 1.
+    template <ewah_bitmap_detail::Operation operation>
+    [[nodiscard]] static EwahBitmap Merge(const EwahBitmap& a, const EwahBitmap& b)
+    {
+        using ewah_bitmap_detail::Operation;
+        assert(a.size_ == b.size_);
+
+        EwahBitmap result;
+        result.size_ = a.size_;
+        EwahReader x = a.GetReader();
+        EwahReader y = b.GetReader();
+        while (!x.IsDone() && !y.IsDone())
+        {
+            if (!x.IsInRun() && !y.IsInRun())
+            {
+                result.AppendWord(ewah_bitmap_detail::Apply<operation>(x.GetLiteral(), y.GetLiteral()));
+                x.Skip(1);
+                y.Skip(1);
+                continue;
+            }
+
+            // The longer run drives
+            const bool x_drives = x.IsInRun() && (!y.IsInRun() || x.GetRunLength() >= y.GetRunLength());
+            EwahReader& run = x_drives ? x : y;
+            EwahReader& another = x_drives ? y : x;
+            const size_t run_length = run.GetRunLength();
+            const bool run_bit = run.GetRunBit();
+            run.Skip(run_length);
+
+            const bool absorbs = (operation == Operation::kAnd && !run_bit) || (operation == Operation::kOr && run_bit);
+            if (absorbs)
+            {
+                result.AppendRun(run_bit, run_length);
+                another.Skip(run_length);
+            }
+            else
+            {
+                result.CopyWords(another, run_length, operation == Operation::kXor && run_bit);
+            }
+        }
+        assert(x.IsDone() && y.IsDone());
+        return result;
+    }
+
+    // Appends `words_count` words from the reader, runs stay runs
+    void CopyWords(EwahReader& reader, size_t words_count, const bool negate)
+    {
+        while (words_count != 0)
+        {
+            assert(!reader.IsDone());
+            if (reader.IsInRun())
+            {
+                const size_t n = std::min(words_count, reader.GetRunLength());
+                AppendRun(reader.GetRunBit() != negate, n);
+                reader.Skip(n);
+                words_count -= n;
+            }
+            else
+            {
+                const uint64_t literal = reader.GetLiteral();
+                AppendWord(negate ? ~literal : literal);
+                reader.Skip(1);
+                --words_count;
+            }
+        }
+    }
+
+    void AppendWord(const uint64_t word)
+    {
+        if (word == 0 || word == ewah_bitmap_detail::kAllOnes)
+        {
+            AppendRun(word != 0, 1);
+            return;
+        }
+
+        if (words_.empty() || marker_.literals_count == ewah_bitmap_detail::kMaxLiteralsCount) StartMarker();
+        words_.push_back(word);
+        ++marker_.literals_count;
+        StoreMarker();
+    }
+
+    void AppendRun(const bool bit, size_t words_count)
+    {
+        while (words_count != 0)
+        {
+            // A run can only precede the literals of its marker
+            const bool can_extend = !words_.empty() && marker_.literals_count == 0 &&
+                                    (marker_.run_length == 0 || marker_.run_bit == bit) &&
+                                    marker_.run_length != ewah_bitmap_detail::kMaxRunLength;
+            if (!can_extend) StartMarker();
+
+            const size_t n = std::min(words_count, ewah_bitmap_detail::kMaxRunLength - marker_.run_length);
+            marker_.run_bit = bit;
+            marker_.run_length += n;
+            words_count -= n;
+            StoreMarker();
+        }
+    }
+
+    void StartMarker()
+    {
+        marker_position_ = words_.size();
+        marker_ = {};
+        words_.push_back(0);
+    }
+
+    void StoreMarker() noexcept
+    {
+        words_[marker_position_] = ewah_bitmap_detail::PackMarker(marker_);
+    }
+
+private:
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+    size_t marker_position_ = 0;
+    ewah_bitmap_detail::Marker marker_;
+};
+}  // namespace ass
@@ -1,12 +1,22 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <cassert>
+#include <concepts>
 #include <cstddef>
 #include <limits>
+#include <span>
+#include <type_traits>
 
 #include "bit/bit_count_to_type.hpp"
+#include "bit/bit_expression.hpp"
+#include "bit/bit_extract.hpp"
+#include "bit/bit_part.hpp"
+#include "bit/bit_range.hpp"
+#include "bit/bit_shift.hpp"
+#include "bit/simd_kernels.hpp"
 
 namespace ass::fixed_bitset_detail
 {
@@ -36,17 +46,52 @@ namespace ass
 {
 
 template <size_t kSize>
+using FixedBitsetDefaultPart = BitsCountToUnsignedIntT<fixed_bitset_detail::GetOptimalPartSize(kSize)>;
+
+// By default the part is the smallest unsigned integer that fits kSize bits (but not larger than 64 bits).
+// Pass Part_ explicitly to match memory layout of a BitSpan view, wire format or another bitset.
+// 128-bit parts (Uint128) are available where the compiler provides unsigned __int128.
+template <size_t kSize, bit_part Part_ = FixedBitsetDefaultPart<kSize>>
 class FixedBitset
 {
 public:
-    static constexpr size_t kPartBitsCount = fixed_bitset_detail::GetOptimalPartSize(kSize);
+    using Part = Part_;
+    static_assert(!std::same_as<Part, bool>, "Part must be an unsigned integer type");
+
+    static constexpr size_t kPartBitsCount = sizeof(Part) * 8;
     static constexpr size_t kPartsCount = fixed_bitset_detail::GetRequiredPartsCount(kSize, kPartBitsCount);
     static constexpr size_t kCapacity = kPartsCount * kPartBitsCount;
     static constexpr size_t kUnusedBitsCount = kCapacity - kSize;
-    using Part = BitsCountToUnsignedIntT<kPartBitsCount>;
 
     constexpr FixedBitset() = default;
 
+    // Evaluates lazy expression like `Lazy(a) & ~Lazy(b) | c` in one pass without temporary bitsets
+    template <bit_expression Expression>
+    constexpr FixedBitset(const Expression& expression)  // NOLINT
+    {
+        *this = expression;
+    }
+
+    template <bit_expression Expression>
+    constexpr FixedBitset& operator=(const Expression& expression)
+    {
+        static_assert(std::same_as<typename Expression::Part, Part>, "Expression must have the same part type");
+        assert(expression.GetSize() == kSize);
+
+        // Every part depends only on the parts with the same index so the expression may refer to this bitset
+        const size_t parts_count = expression.GetPartsCount();
+        for (size_t part_index = 0; part_index != parts_count; ++part_index)
+        {
+            parts_[part_index] = expression.GetPart(part_index);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] friend constexpr BitPartsExpression<Part> ToBitExpression(const FixedBitset& bitset) noexcept
+    {
+        return BitPartsExpression<Part>(bitset.parts_.data(), kSize);
+    }
+
     constexpr bool Get(size_t index) const
     {
         const auto [part_index, bit_index] = DecomposeIndex(index);
@@ -76,22 +121,15 @@ public:
 
     constexpr size_t CountOnes() const
     {
-        size_t n = 0;
         if constexpr (kUnusedBitsCount == 0)
         {
-            for (Part p : parts_)
-            {
-                n += static_cast<size_t>(std::popcount(p));
-            }
+            return CountOnesInFirstParts(kPartsCount);
         }
         else
         {
             // Have to mask out unused bits
-            size_t last_part_index = kPartsCount - 1;
-            for (size_t part_index = 0; part_index != last_part_index; ++part_index)
-            {
-                n += static_cast<size_t>(std::popcount(parts_[part_index]));
-            }
+            const size_t last_part_index = kPartsCount - 1;
+            size_t n = CountOnesInFirstParts(last_part_index);
 
             Part mask{};
             mask = ~mask;
@@ -100,63 +138,158 @@ public:
             Part part = parts_[last_part_index];
             part &= mask;
 
-            n += static_cast<size_t>(std::popcount(part));
+            n += static_cast<size_t>(bit_part_detail::PopCount(part));
+            return n;
         }
-        return n;
     }
 
-    constexpr size_t CountContinuousZeroBits() const
+    // Predicates and counters below work part by part on the fly: nothing is materialized
+    // and predicates stop at the first part that decides the answer.
+    [[nodiscard]] constexpr bool Any() const noexcept
+    {
+        return ToBitExpression(*this).Any();
+    }
+
+    [[nodiscard]] constexpr bool None() const noexcept
     {
-        size_t result = 0;
-        for (size_t part_index = 0; part_index != parts_.size(); ++part_index)
+        return ToBitExpression(*this).None();
+    }
+
+    [[nodiscard]] constexpr bool All() const noexcept
+    {
+        return ToBitExpression(*this).All();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr bool Intersects(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) & another).Any();
+    }
+
+    // True if every bit set here is also set in another
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr bool IsSubsetOf(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) & ~Lazy(another)).None();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t AndCount(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) & another).CountOnes();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t OrCount(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) | another).CountOnes();
+    }
+
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr size_t XorCount(const Operand& another) const noexcept
+    {
+        return (Lazy(*this) ^ another).CountOnes();
+    }
+
+    // Range operations work on half-open interval [begin, end).
+    // Edge parts are masked and inner parts are written wholesale, so long runs cost a memset.
+    constexpr void SetRange(const size_t begin, const size_t end)
+    {
+        assert(end <= kSize);
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kSet>(parts_.data(), begin, end);
+    }
+
+    constexpr void ResetRange(const size_t begin, const size_t end)
+    {
+        assert(end <= kSize);
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kReset>(parts_.data(), begin, end);
+    }
+
+    constexpr void FlipRange(const size_t begin, const size_t end)
+    {
+        assert(end <= kSize);
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kFlip>(parts_.data(), begin, end);
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes(const size_t begin, const size_t end) const
+    {
+        assert(end <= kSize);
+        return bit_range_detail::CountOnesInRange(parts_.data(), begin, end);
+    }
+
+    // Search functions return kSize if there is no matching bit
+
+    // Returns index of the first set bit at or after `from_index`
+    [[nodiscard]] constexpr size_t FindNextSet(const size_t from_index = 0) const noexcept
+    {
+        return FindNext<false>(from_index);
+    }
+
+    // Returns index of the first zero bit at or after `from_index`
+    [[nodiscard]] constexpr size_t FindNextZero(const size_t from_index = 0) const noexcept
+    {
+        return FindNext<true>(from_index);
+    }
+
+    // Returns index of the last set bit at or before `from_index`
+    [[nodiscard]] constexpr size_t FindPrevSet(size_t from_index = kSize) const noexcept
+    {
+        if constexpr (kSize == 0)
+        {
+            return kSize;
+        }
+        else
         {
-            const Part& part = parts_[part_index];
-            const size_t local = std::countr_zero(part);
-            result += local;
-            if (local != kPartBitsCount)
+            from_index = std::min(from_index, kSize - 1);
+            auto [part_index, bit_index] = DecomposeIndex(from_index);
+            Part part = parts_[part_index] & static_cast<Part>(kAllOnes >> (kPartBitsCount - 1 - bit_index));
+            while (part == 0)
             {
-                break;
+                if (part_index == 0)
+                {
+                    return kSize;
+                }
+
+                part = parts_[--part_index];
             }
+
+            return part_index * kPartBitsCount + kPartBitsCount - 1 - static_cast<size_t>(bit_part_detail::CountLeftZero(part));
         }
-        return std::min(result, kSize);
     }
 
-    constexpr size_t CountContinuousZeroBits(const size_t ignore_first_n) const
+    // Calls f(index) for every set bit in ascending order.
+    // Set bits are extracted from one part at a time so empty regions cost one comparison per part.
+    template <typename F>
+    constexpr void ForEachSetBit(F&& f) const
     {
-        // Skip ignored parts
-        size_t part_index = ignore_first_n / kPartBitsCount;
-        size_t result = part_index * kPartBitsCount;
-
-        // Deal with remaining ignored bits
-        if (ignore_first_n > result)
+        for (size_t part_index = 0; part_index != kPartsCount; ++part_index)
         {
-            const size_t ignored_bits = ignore_first_n - result;
-            Part mask{};
-            mask = ~mask;
-            mask <<= ignored_bits;
-            const Part part = parts_[part_index] & mask;
-            const size_t local = std::countr_zero(part);
-            if (local != kPartBitsCount)
+            Part part = parts_[part_index];
+            if constexpr (kUnusedBitsCount != 0)
             {
-                return result + local;
+                if (part_index == kPartsCount - 1)
+                {
+                    part &= kAllOnes >> kUnusedBitsCount;
+                }
             }
-            part_index += 1;
-            result += kPartBitsCount;
-        }
 
-        // then do the same as in default overload without argument
-        for (; part_index != parts_.size(); ++part_index)
-        {
-            const Part& part = parts_[part_index];
-            const size_t local = std::countr_zero(part);
-            result += local;
-            if (local != kPartBitsCount)
+            while (part != 0)
             {
-                break;
+                const size_t bit_index = static_cast<size_t>(bit_part_detail::CountRightZero(part));
+                part &= static_cast<Part>(part - 1);
+                f(part_index * kPartBitsCount + bit_index);
             }
         }
+    }
+
+    constexpr size_t CountContinuousZeroBits() const
+    {
+        return FindNextSet(0);
+    }
 
-        return std::min(result, kSize);
+    constexpr size_t CountContinuousZeroBits(const size_t ignore_first_n) const
+    {
+        return FindNextSet(ignore_first_n);
     }
 
     constexpr FixedBitset operator~() const
@@ -168,11 +301,29 @@ public:
 
     constexpr void Flip()
     {
+        if constexpr (kUseSimdKernels)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                simd::GetBitKernels().not_inplace(GetBytes(), sizeof(parts_));
+                return;
+            }
+        }
+
         for (Part& part : parts_) part = ~part;
     }
 
     constexpr FixedBitset& operator|=(const FixedBitset& another)
     {
+        if constexpr (kUseSimdKernels)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                simd::GetBitKernels().or_inplace(GetBytes(), another.GetBytes(), sizeof(parts_));
+                return *this;
+            }
+        }
+
         for (size_t index = 0; index != kPartsCount; ++index)
         {
             parts_[index] |= another.parts_[index];
@@ -189,6 +340,15 @@ public:
 
     constexpr FixedBitset& operator&=(const FixedBitset& another)
     {
+        if constexpr (kUseSimdKernels)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                simd::GetBitKernels().and_inplace(GetBytes(), another.GetBytes(), sizeof(parts_));
+                return *this;
+            }
+        }
+
         for (size_t index = 0; index != kPartsCount; ++index)
         {
             parts_[index] &= another.parts_[index];
@@ -203,11 +363,134 @@ public:
         return copy;
     }
 
+    constexpr FixedBitset& operator^=(const FixedBitset& another)
+    {
+        if constexpr (kUseSimdKernels)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                simd::GetBitKernels().xor_inplace(GetBytes(), another.GetBytes(), sizeof(parts_));
+                return *this;
+            }
+        }
+
+        for (size_t index = 0; index != kPartsCount; ++index)
+        {
+            parts_[index] ^= another.parts_[index];
+        }
+        return *this;
+    }
+
+    constexpr FixedBitset operator^(const FixedBitset& another) const
+    {
+        auto copy = *this;
+        copy ^= another;
+        return copy;
+    }
+
+    // Compound assignment from any operand or lazy expression (see bit/bit_expression.hpp)
+    template <bit_expression_operand Operand>
+    constexpr FixedBitset& operator|=(const Operand& operand)
+    {
+        return *this = Lazy(*this) | operand;
+    }
+
+    template <bit_expression_operand Operand>
+    constexpr FixedBitset& operator&=(const Operand& operand)
+    {
+        return *this = Lazy(*this) & operand;
+    }
+
+    template <bit_expression_operand Operand>
+    constexpr FixedBitset& operator^=(const Operand& operand)
+    {
+        return *this = Lazy(*this) ^ operand;
+    }
+
+    // Same as for std::bitset: bit i moves to i + shift, vacated bits become zeros
+    constexpr FixedBitset& operator<<=(const size_t shift)
+    {
+        bit_shift_detail::ShiftLeft(parts_.data(), kSize, shift);
+        return *this;
+    }
+
+    constexpr FixedBitset operator<<(const size_t shift) const
+    {
+        auto copy = *this;
+        copy <<= shift;
+        return copy;
+    }
+
+    // Bit i moves to i - shift, vacated bits become zeros
+    constexpr FixedBitset& operator>>=(const size_t shift)
+    {
+        bit_shift_detail::ShiftRight(parts_.data(), kSize, shift);
+        return *this;
+    }
+
+    constexpr FixedBitset operator>>(const size_t shift) const
+    {
+        auto copy = *this;
+        copy >>= shift;
+        return copy;
+    }
+
+    // Bit i moves to (i + shift) % kSize
+    constexpr FixedBitset& RotateLeft(const size_t shift)
+    {
+        bit_shift_detail::RotateLeft(parts_.data(), kSize, shift);
+        return *this;
+    }
+
+    // Bit i moves to (i - shift) % kSize
+    constexpr FixedBitset& RotateRight(const size_t shift)
+    {
+        if constexpr (kSize != 0)
+        {
+            RotateLeft(kSize - shift % kSize);
+        }
+        return *this;
+    }
+
+    // PEXT over the whole bitset: bits selected by the mask are packed into the lowest bits of the result
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr FixedBitset ExtractBits(const Operand& mask) const noexcept
+    {
+        const auto mask_expression = ToBitExpression(mask);
+        assert(mask_expression.GetSize() == kSize);
+        FixedBitset result;
+        bit_extract_detail::ExtractBits(parts_.data(), mask_expression, result.parts_.data(), kSize);
+        return result;
+    }
+
+    // PDEP over the whole bitset: the lowest bits are spread to the positions selected by the mask
+    template <bit_expression_operand Operand>
+    [[nodiscard]] constexpr FixedBitset DepositBits(const Operand& mask) const noexcept
+    {
+        const auto mask_expression = ToBitExpression(mask);
+        assert(mask_expression.GetSize() == kSize);
+        FixedBitset result;
+        bit_extract_detail::DepositBits(parts_.data(), kSize, mask_expression, result.parts_.data());
+        return result;
+    }
+
     constexpr const Part& GetPart(const size_t index) const
     {
         return parts_[index];
     }
 
+    // Parts can be viewed as a BitSpan without copying: ToBitSpan<{.size = kSize}>(bitset.GetParts()).
+    // Bits past kSize in the last part are unspecified.
+    [[nodiscard]] constexpr std::span<Part, kPartsCount> GetParts() noexcept
+    {
+        return parts_;
+    }
+
+    [[nodiscard]] constexpr std::span<const Part, kPartsCount> GetParts() const noexcept
+    {
+        return parts_;
+    }
+
     constexpr void Fill(bool value)
     {
         if (value)
@@ -221,6 +504,68 @@ public:
     }
 
 private:
+    static constexpr Part kAllOnes = std::numeric_limits<Part>::max();
+
+    template <bool zeros>
+    [[nodiscard]] constexpr size_t FindNext(const size_t from_index) const noexcept
+    {
+        if (from_index >= kSize)
+        {
+            return kSize;
+        }
+
+        auto [part_index, bit_index] = DecomposeIndex(from_index);
+        auto read_part = [&](const size_t index)
+        {
+            return zeros ? static_cast<Part>(~parts_[index]) : parts_[index];
+        };
+
+        Part part = read_part(part_index) & static_cast<Part>(kAllOnes << bit_index);
+        while (part == 0)
+        {
+            if (++part_index == kPartsCount)
+            {
+                return kSize;
+            }
+
+            part = read_part(part_index);
+        }
+
+        // Unused bits of the last part might be set
+        return std::min(part_index * kPartBitsCount + static_cast<size_t>(bit_part_detail::CountRightZero(part)), kSize);
+    }
+
+    // Large bitsets use explicit SIMD kernels at runtime. Constant evaluation always takes scalar loops.
+    static constexpr bool kUseSimdKernels = kPartsCount * sizeof(Part) >= simd::kMinBytesForSimdKernels;
+
+    unsigned char* GetBytes() noexcept
+    {
+        return reinterpret_cast<unsigned char*>(parts_.data());
+    }
+
+    const unsigned char* GetBytes() const noexcept
+    {
+        return reinterpret_cast<const unsigned char*>(parts_.data());
+    }
+
+    constexpr size_t CountOnesInFirstParts(const size_t parts_count) const
+    {
+        if constexpr (kUseSimdKernels)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return simd::GetBitKernels().count_ones(GetBytes(), parts_count * sizeof(Part));
+            }
+        }
+
+        size_t n = 0;
+        for (size_t part_index = 0; part_index != parts_count; ++part_index)
+        {
+            n += static_cast<size_t>(bit_part_detail::PopCount(parts_[part_index]));
+        }
+        return n;
+    }
+
     static constexpr std::pair<size_t, size_t> DecomposeIndex(size_t index) noexcept
     {
         const size_t part_index = index / kPartBitsCount;
@@ -3,9 +3,12 @@
 #include <cassert>
 #include <optional>
 #include <type_traits>
+#include <utility>
 
+#include "counted_bits.hpp"
 #include "fixed_bitset.hpp"
 #include "invalid_index.hpp"
+#include "probe_policy.hpp"
 
 namespace ass
 {
@@ -68,19 +71,37 @@ private:
     size_t index_ = 0;
 };
 
-template <size_t capacity, typename Key_, typename Value_, typename Hasher_>
+// Pass cached_size = true to keep the number of keys in a counter (see counted_bits.hpp): Size() becomes O(1)
+// at the cost of a few bytes and a counter update on every insert and removal.
+template <
+    size_t capacity,
+    typename Key_,
+    typename Value_,
+    typename Hasher_,
+    typename ProbePolicy_ = LinearProbing,
+    bool cached_size = false>
 class FixedUnorderedMap
 {
 public:
     using Key = Key_;
     using Value = Value_;
     using Hasher = Hasher_;
-    using Self = FixedUnorderedMap<capacity, Key, Value, Hasher>;
+    using ProbePolicy = ProbePolicy_;
+    using ProbeSequence = typename ProbePolicy::template Sequence<capacity>;
+    using Self = FixedUnorderedMap<capacity, Key, Value, Hasher, ProbePolicy, cached_size>;
     using Iterator = FixedUnorderedMapIterator<Self>;
     using ConstIterator = FixedUnorderedMapIterator<std::add_const_t<Self>>;
     friend Iterator;
     friend ConstIterator;
 
+    template <size_t, typename, typename, typename, typename, bool>
+    friend class FixedUnorderedMap;
+
+    static constexpr bool kCachedSize = cached_size;
+
+    // EraseIf drops tombstones once they take more than 1/kTombstonesDropFraction of the slots
+    static constexpr size_t kTombstonesDropFraction = 4;
+
     constexpr FixedUnorderedMap() = default;
 
     constexpr bool Contains(const Key key) const
@@ -103,8 +124,7 @@ public:
 
     constexpr size_t FindKeyIndex(const Key& key) const
     {
-        constexpr bool stop_at_deleted = false;
-        return FindIndexForKey<stop_at_deleted>(key);
+        return Probe(key).index;
     }
 
     constexpr const Value& GetAtIndex(const size_t index) const
@@ -127,9 +147,13 @@ public:
             return nullptr;
         }
 
+        if (has_index_.Set(index, true))
+        {
+            keys_[index] = key;
+            was_deleted_.Set(index, false);
+        }
+
         Value& value = values_[index];
-        has_index_.Set(index, true);
-        was_deleted_.Set(index, false);
         value = Value(std::forward<Args>(args)...);
         return &value;
     }
@@ -217,6 +241,144 @@ public:
         return has_index_.CountOnes();
     }
 
+    // Returns the number of slots visited by lookup of the specified key (including the last one).
+    // Useful to measure how well the hasher and probe policy work together.
+    constexpr size_t CountProbes(const Key& key) const
+    {
+        return Probe(key).probes_count;
+    }
+
+    // Removes all key-value pairs for which predicate(key, value) returns true.
+    // Occupied slots are visited word by word. Dropping tombstones is a second walk that re-places every key,
+    // so it is done only once tombstones take more than 1/kTombstonesDropFraction of the slots.
+    // Returns the number of removed pairs.
+    template <typename Predicate>
+    constexpr size_t EraseIf(Predicate&& predicate)
+    {
+        size_t removed = 0;
+        ForEachIndexWithValue(
+            [&](const size_t index)
+            {
+                if (predicate(std::as_const(keys_[index]), values_[index]))
+                {
+                    has_index_.Set(index, false);
+                    was_deleted_.Set(index, true);
+                    values_[index] = Value{};
+                    ++removed;
+                }
+            });
+
+        // Outside of DropTombstones every was_deleted_ bit marks a tombstone
+        if (removed != 0 && was_deleted_.CountOnes() * kTombstonesDropFraction > capacity)
+        {
+            DropTombstones();
+        }
+
+        return removed;
+    }
+
+    // Keeps only keys that are also present in another collection (anything with `Contains(key)`)
+    template <typename Another>
+    constexpr size_t IntersectWith(const Another& another)
+    {
+        return EraseIf(
+            [&](const Key& key, const Value&)
+            {
+                return !another.Contains(key);
+            });
+    }
+
+    // Removes keys that are present in another collection (anything with `Contains(key)`)
+    template <typename Another>
+    constexpr size_t Subtract(const Another& another)
+    {
+        return EraseIf(
+            [&](const Key& key, const Value&)
+            {
+                return another.Contains(key);
+            });
+    }
+
+    // Adds all pairs from another map. For keys present in both maps calls merge(this_value, another_value).
+    // Returns false if some keys did not fit (the rest are merged anyway).
+    template <typename AnotherMap, typename MergeFunction>
+    constexpr bool MergeFrom(const AnotherMap& another, MergeFunction&& merge)
+    {
+        bool all_fit = true;
+        another.ForEachIndexWithValue(
+            [&](const size_t another_index)
+            {
+                const Key& key = another.GetKeyAt(another_index);
+                const Value& another_value = another.GetValueAt(another_index);
+                const size_t index = FindFreeIndexForKey(key);
+                if (index == kInvalidIndex)
+                {
+                    all_fit = false;
+                }
+                else if (has_index_.Get(index))
+                {
+                    merge(values_[index], another_value);
+                }
+                else
+                {
+                    has_index_.Set(index, true);
+                    was_deleted_.Set(index, false);
+                    keys_[index] = key;
+                    values_[index] = another_value;
+                }
+            });
+        return all_fit;
+    }
+
+    // Adds all pairs from another map. Values from another map win for keys present in both maps.
+    template <typename AnotherMap>
+    constexpr bool MergeFrom(const AnotherMap& another)
+    {
+        return MergeFrom(
+            another,
+            [](Value& value, const Value& another_value)
+            {
+                value = another_value;
+            });
+    }
+
+    // Places every key as close to the start of its probe sequence as possible and forgets all tombstones.
+    // Lookups of missing keys get shorter after many removals.
+    constexpr void DropTombstones()
+    {
+        // Occupied slots are temporarily marked as both present and deleted: "waiting for placement".
+        was_deleted_ = Lazy(has_index_);
+
+        for (size_t index = 0; index != capacity; ++index)
+        {
+            while (IsWaitingForPlacement(index))
+            {
+                const size_t target = FindPlacementIndex(keys_[index]);
+                if (target == index)
+                {
+                    was_deleted_.Set(index, false);
+                }
+                else if (!has_index_.Get(target))
+                {
+                    // Target slot is empty: move there and free this one
+                    keys_[target] = std::move(keys_[index]);
+                    values_[target] = std::move(values_[index]);
+                    has_index_.Set(target, true);
+                    has_index_.Set(index, false);
+                    was_deleted_.Set(index, false);
+                    values_[index] = Value{};
+                }
+                else
+                {
+                    // Target slot also waits for placement: swap and place the element that came here
+                    std::swap(keys_[target], keys_[index]);
+                    std::swap(values_[target], values_[index]);
+                    was_deleted_.Set(target, false);
+                }
+            }
+        }
+    }
+
     // STL conformance
     constexpr Iterator begin() noexcept
     {
@@ -273,45 +435,93 @@ protected:
         return It(*this_, capacity);
     }
 
+    // Returns the slot that holds the key or the slot where it should be placed.
+    // The key may be stored after deleted slots, so the first deleted slot is only taken
+    // when the key is not found further along the probe sequence.
     constexpr size_t FindFreeIndexForKey(const Key key) const
     {
-        constexpr bool stop_at_deleted = true;
-        return FindIndexForKey<stop_at_deleted>(key);
-    }
-
-    template <bool kStopAtDeleted>
-    constexpr size_t FindIndexForKey(const Key key) const
-    {
-        const size_t start_index = ToIndex(Hasher{}(key));
-        for (size_t collision_index = 0; collision_index != capacity; ++collision_index)
+        size_t first_deleted_index = kInvalidIndex;
+        ProbeSequence probe(Hasher{}(key));
+        for (size_t collision_index = 0; collision_index != capacity; ++collision_index, probe.Next())
         {
-            const size_t index = ToIndex(start_index + collision_index);
-            if constexpr (kStopAtDeleted)
+            const size_t index = probe.GetIndex();
+            if (has_index_.Get(index))
             {
-                if (!has_index_.Get(index) || keys_[index] == key)
+                if (keys_[index] == key)
                 {
                     return index;
                 }
             }
-            else
+            else if (!was_deleted_.Get(index))
             {
-                if (has_index_.Get(index))
-                {
-                    if (keys_[index] == key)
-                    {
-                        return index;
-                    }
-                }
-                else if (!was_deleted_.Get(index))
+                return first_deleted_index == kInvalidIndex ? index : first_deleted_index;
+            }
+            else if (first_deleted_index == kInvalidIndex)
+            {
+                first_deleted_index = index;
+            }
+        }
+
+        return first_deleted_index;
+    }
+
+    struct ProbeResult
+    {
+        size_t index = kInvalidIndex;
+        size_t probes_count = 0;
+    };
+
+    constexpr ProbeResult Probe(const Key& key) const
+    {
+        ProbeSequence probe(Hasher{}(key));
+        for (size_t collision_index = 0; collision_index != capacity; ++collision_index, probe.Next())
+        {
+            const size_t index = probe.GetIndex();
+            if (has_index_.Get(index))
+            {
+                if (keys_[index] == key)
                 {
-                    return index;
+                    return {index, collision_index + 1};
                 }
             }
+            else if (!was_deleted_.Get(index))
+            {
+                return {index, collision_index + 1};
+            }
         }
 
+        return {kInvalidIndex, capacity};
+    }
+
+    constexpr bool IsWaitingForPlacement(const size_t index) const
+    {
+        return has_index_.Get(index) && was_deleted_.Get(index);
+    }
+
+    // First slot in the probe sequence of the key that is not taken by an already placed key
+    constexpr size_t FindPlacementIndex(const Key& key) const
+    {
+        ProbeSequence probe(Hasher{}(key));
+        for (size_t collision_index = 0; collision_index != capacity; ++collision_index, probe.Next())
+        {
+            const size_t index = probe.GetIndex();
+            if (!has_index_.Get(index) || was_deleted_.Get(index))
+            {
+                return index;
+            }
+        }
+
+        assert(false);
         return kInvalidIndex;
     }
 
+    // Calls f(index) for every occupied slot
+    template <typename F>
+    constexpr void ForEachIndexWithValue(F&& f) const
+    {
+        has_index_.ForEachSetBit(std::forward<F>(f));
+    }
+
     constexpr bool HasValueAtIndex(size_t index) const noexcept
     {
         if (index < capacity)
@@ -324,13 +534,13 @@ protected:
 
     constexpr size_t GetFirstIndexWithValue() const noexcept
     {
-        return has_index_.CountContinuousZeroBits();
+        return has_index_.FindNextSet();
     }
 
     constexpr size_t GetNextIndexWithValue(size_t prev_index) const noexcept
     {
         assert(prev_index <= capacity);
-        return has_index_.CountContinuousZeroBits(prev_index + 1);
+        return has_index_.FindNextSet(prev_index + 1);
     }
 
     constexpr const Key& GetKeyAt(size_t index) const noexcept
@@ -349,9 +559,11 @@ protected:
     }
 
 private:
+    using OccupancyBits = std::conditional_t<cached_size, CountedBits<FixedBitset<capacity>>, FixedBitset<capacity>>;
+
     std::array<Key, capacity> keys_{};
     std::array<Value, capacity> values_{};
-    FixedBitset<capacity> has_index_{};
+    OccupancyBits has_index_{};
     FixedBitset<capacity> was_deleted_{};
 };
 }  // namespace ass
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <cassert>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "fixed_unordered_map.hpp"
+#include "invalid_index.hpp"
+#include "probe_policy.hpp"
+
+namespace ass
+{
+
+template <typename Collection>
+class FixedUnorderedMultiMapValuesIterator
+{
+public:
+    using CleanCollection = std::remove_const_t<Collection>;
+    using Value = std::conditional_t<
+        std::is_const_v<Collection>,
+        std::add_const_t<typename CleanCollection::Value>,
+        typename CleanCollection::Value>;
+
+    constexpr FixedUnorderedMultiMapValuesIterator(Collection& collection, size_t index)
+        : collection_(&collection),
+          index_(index)
+    {
+    }
+
+    constexpr bool operator==(const FixedUnorderedMultiMapValuesIterator& another) const noexcept
+    {
+        return collection_ == another.collection_ && index_ == another.index_;
+    }
+
+    constexpr bool operator!=(const FixedUnorderedMultiMapValuesIterator& another) const noexcept
+    {
+        return !(*this == another);
+    }
+
+    constexpr FixedUnorderedMultiMapValuesIterator& operator++() noexcept
+    {
+        index_ = collection_->GetNextValueIndex(index_);
+        return *this;
+    }
+
+    constexpr Value& operator*() const noexcept
+    {
+        return collection_->GetValueAt(index_);
+    }
+
+private:
+    Collection* collection_ = nullptr;
+    size_t index_ = kInvalidIndex;
+};
+
+// Range of values associated with one key. Iterates values in insertion order.
+template <typename Collection>
+class FixedUnorderedMultiMapValuesRange
+{
+public:
+    using Iterator = FixedUnorderedMultiMapValuesIterator<Collection>;
+
+    constexpr FixedUnorderedMultiMapValuesRange(Collection& collection, size_t first_index, size_t size)
+        : collection_(&collection),
+          first_index_(first_index),
+          size_(size)
+    {
+    }
+
+    [[nodiscard]] constexpr size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr bool IsEmpty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    // STL conformance
+    constexpr Iterator begin() const noexcept
+    {
+        return Iterator(*collection_, first_index_);
+    }
+
+    constexpr Iterator end() const noexcept
+    {
+        return Iterator(*collection_, kInvalidIndex);
+    }
+
+private:
+    Collection* collection_ = nullptr;
+    size_t first_index_ = kInvalidIndex;
+    size_t size_ = 0;
+};
+
+// Unordered map that can associate several values with the same key.
+// Keys live in FixedUnorderedMap and every key refers to a chain of value slots.
+// Value slots are stored in a single fixed pool and linked through slot indices, so no heap allocations are made.
+// `capacity` limits both the number of distinct keys and the total number of values.
+template <size_t capacity, typename Key_, typename Value_, typename Hasher_, typename ProbePolicy_ = LinearProbing>
+class FixedUnorderedMultiMap
+{
+public:
+    using Key = Key_;
+    using Value = Value_;
+    using Hasher = Hasher_;
+    using ProbePolicy = ProbePolicy_;
+    using Self = FixedUnorderedMultiMap<capacity, Key, Value, Hasher, ProbePolicy>;
+    using ValuesRange = FixedUnorderedMultiMapValuesRange<Self>;
+    using ConstValuesRange = FixedUnorderedMultiMapValuesRange<std::add_const_t<Self>>;
+    friend typename ValuesRange::Iterator;
+    friend typename ConstValuesRange::Iterator;
+
+    constexpr FixedUnorderedMultiMap() = default;
+
+    static constexpr size_t Capacity() noexcept
+    {
+        return capacity;
+    }
+
+    // Total number of values
+    constexpr size_t Size() const noexcept
+    {
+        return values_count_;
+    }
+
+    // Number of distinct keys
+    constexpr size_t KeysCount() const
+    {
+        return chains_.Size();
+    }
+
+    constexpr bool Contains(const Key& key) const
+    {
+        return chains_.Find(key) != nullptr;
+    }
+
+    // Number of values associated with the key
+    constexpr size_t Count(const Key& key) const
+    {
+        const Chain* chain = chains_.Find(key);
+        return chain ? chain->size : 0;
+    }
+
+    // Appends one more value to the key. Returns nullptr if there are no free slots for the key or the value.
+    template <typename... Args>
+    constexpr Value* TryEmplace(const Key& key, Args&&... args)
+    {
+        if (values_count_ == capacity)
+        {
+            return nullptr;
+        }
+
+        Chain* chain = chains_.TryAdd(key);
+        if (!chain)
+        {
+            return nullptr;
+        }
+
+        const size_t index = AllocateSlot();
+        values_[index] = Value(std::forward<Args>(args)...);
+
+        if (chain->size == 0)
+        {
+            chain->first = index;
+        }
+        else
+        {
+            next_[chain->last] = index;
+        }
+
+        chain->last = index;
+        ++chain->size;
+        return &values_[index];
+    }
+
+    template <typename... Args>
+    constexpr Value& Emplace(const Key& key, Args&&... args)
+    {
+        auto ptr = TryEmplace(key, std::forward<Args>(args)...);
+        assert(ptr);
+        return *ptr;
+    }
+
+    constexpr Value* TryAdd(const Key& key, Value value)
+    {
+        return TryEmplace(key, std::move(value));
+    }
+
+    constexpr Value& Add(const Key& key, Value value)
+    {
+        return Emplace(key, std::move(value));
+    }
+
+    // Returns all values associated with the key
+    [[nodiscard]] constexpr ValuesRange EqualRange(const Key& key)
+    {
+        const Chain* chain = chains_.Find(key);
+        return chain ? ValuesRange(*this, chain->first, chain->size) : ValuesRange(*this, kInvalidIndex, 0);
+    }
+
+    [[nodiscard]] constexpr ConstValuesRange EqualRange(const Key& key) const
+    {
+        const Chain* chain = chains_.Find(key);
+        return chain ? ConstValuesRange(*this, chain->first, chain->size) : ConstValuesRange(*this, kInvalidIndex, 0);
+    }
+
+    // Removes the key with all associated values. Returns the number of removed values.
+    constexpr size_t Remove(const Key& key)
+    {
+        const std::optional<Chain> chain = chains_.Remove(key);
+        if (!chain)
+        {
+            return 0;
+        }
+
+        for (size_t index = chain->first; index != kInvalidIndex;)
+        {
+            const size_t next = next_[index];
+            ReleaseSlot(index);
+            index = next;
+        }
+
+        return chain->size;
+    }
+
+    // Removes values of the key for which the predicate returns true.
+    // The key itself is removed when it has no values left. Returns the number of removed values.
+    template <typename Predicate>
+    constexpr size_t RemoveIf(const Key& key, Predicate&& predicate)
+    {
+        Chain* chain = chains_.Find(key);
+        if (!chain)
+        {
+            return 0;
+        }
+
+        size_t removed = 0;
+        size_t prev = kInvalidIndex;
+        for (size_t index = chain->first; index != kInvalidIndex;)
+        {
+            const size_t next = next_[index];
+            if (predicate(std::as_const(values_[index])))
+            {
+                if (prev == kInvalidIndex)
+                {
+                    chain->first = next;
+                }
+                else
+                {
+                    next_[prev] = next;
+                }
+
+                if (chain->last == index)
+                {
+                    chain->last = prev;
+                }
+
+                ReleaseSlot(index);
+                ++removed;
+            }
+            else
+            {
+                prev = index;
+            }
+
+            index = next;
+        }
+
+        chain->size -= removed;
+        if (chain->size == 0)
+        {
+            chains_.Remove(key);
+        }
+
+        return removed;
+    }
+
+private:
+    struct Chain
+    {
+        size_t first = kInvalidIndex;
+        size_t last = kInvalidIndex;
+        size_t size = 0;
+    };
+
+    // Reuses released slots first, then takes never used ones
+    constexpr size_t AllocateSlot()
+    {
+        size_t index = free_head_;
+        if (index != kInvalidIndex)
+        {
+            free_head_ = next_[index];
+        }
+        else
+        {
+            assert(never_used_begin_ != capacity);
+            index = never_used_begin_++;
+        }
+
+        next_[index] = kInvalidIndex;
+        ++values_count_;
+        return index;
+    }
+
+    constexpr void ReleaseSlot(const size_t index)
+    {
+        values_[index] = Value{};
+        next_[index] = free_head_;
+        free_head_ = index;
+        --values_count_;
+    }
+
+    constexpr size_t GetNextValueIndex(const size_t index) const noexcept
+    {
+        return next_[index];
+    }
+
+    constexpr Value& GetValueAt(const size_t index) noexcept
+    {
+        return values_[index];
+    }
+
+    constexpr const Value& GetValueAt(const size_t index) const noexcept
+    {
+        return values_[index];
+    }
+
+private:
+    FixedUnorderedMap<capacity, Key, Chain, Hasher, ProbePolicy> chains_{};
+    std::array<Value, capacity> values_{};
+    std::array<size_t, capacity> next_{};
+    size_t free_head_ = kInvalidIndex;
+    size_t never_used_begin_ = 0;
+    size_t values_count_ = 0;
+};
+}  // namespace ass
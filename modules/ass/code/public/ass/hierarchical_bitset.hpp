@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "invalid_index.hpp"
+
+namespace ass::hierarchical_bitset_detail
+{
+inline constexpr size_t kBitsPerWord = 64;
+
+inline constexpr size_t DivCeil(size_t value, size_t divisor)
+{
+    return (value + divisor - 1) / divisor;
+}
+
+// Level 0 holds the bits themselves. Every next level has one bit per word of the previous level.
+// The last level always fits into one word.
+inline constexpr size_t GetLevelsCount(size_t size)
+{
+    size_t words_count = DivCeil(std::max<size_t>(size, 1), kBitsPerWord);
+    size_t levels_count = 1;
+    while (words_count > 1)
+    {
+        words_count = DivCeil(words_count, kBitsPerWord);
+        ++levels_count;
+    }
+    return levels_count;
+}
+
+template <size_t size, size_t levels_count = GetLevelsCount(size)>
+struct Layout
+{
+    static constexpr size_t kLevelsCount = levels_count;
+
+    // Number of meaningful bits on every level
+    static constexpr std::array<size_t, kLevelsCount> kBitsCount = []
+    {
+        std::array<size_t, kLevelsCount> r{};
+        r[0] = size;
+        for (size_t level = 1; level != kLevelsCount; ++level)
+        {
+            r[level] = DivCeil(r[level - 1], kBitsPerWord);
+        }
+        return r;
+    }();
+
+    // Offset of the first word of every level in the common words array
+    static constexpr std::array<size_t, kLevelsCount> kOffsets = []
+    {
+        std::array<size_t, kLevelsCount> r{};
+        for (size_t level = 1; level != kLevelsCount; ++level)
+        {
+            r[level] = r[level - 1] + std::max<size_t>(DivCeil(kBitsCount[level - 1], kBitsPerWord), 1);
+        }
+        return r;
+    }();
+
+    static constexpr size_t kWordsCount =
+        kOffsets.back() + std::max<size_t>(DivCeil(kBitsCount.back(), kBitsPerWord), 1);
+};
+}  // namespace ass::hierarchical_bitset_detail
+
+namespace ass
+{
+
+// Bitset for huge and sparse sets with fast search.
+// Besides the bits themselves it keeps summary levels: bit i of level L+1 is set if word i of level L is not zero.
+// Search for the next or previous set bit climbs the summaries to skip empty regions and touches
+// O(log64(kSize)) words. Set keeps the summaries up to date, which usually costs one extra word write.
+template <size_t kSize>
+class HierarchicalBitset
+{
+    using Layout = hierarchical_bitset_detail::Layout<kSize>;
+    static constexpr size_t kBitsPerWord = hierarchical_bitset_detail::kBitsPerWord;
+
+public:
+    using Word = uint64_t;
+
+    static constexpr size_t kLevelsCount = Layout::kLevelsCount;
+
+    constexpr HierarchicalBitset() = default;
+
+    static constexpr size_t Size() noexcept
+    {
+        return kSize;
+    }
+
+    [[nodiscard]] constexpr bool Get(const size_t index) const
+    {
+        assert(index < kSize);
+        return (GetWord(0, index / kBitsPerWord) >> (index % kBitsPerWord)) & 1;
+    }
+
+    // Returns true if bit at specified index was flipped
+    constexpr bool Set(const size_t index, const bool value)
+    {
+        assert(index < kSize);
+        size_t position = index;
+        for (size_t level = 0; level != kLevelsCount; ++level)
+        {
+            Word& word = GetWord(level, position / kBitsPerWord);
+            const Word prev_word = word;
+            const Word mask = Word{1} << (position % kBitsPerWord);
+            if (value)
+            {
+                word |= mask;
+            }
+            else
+            {
+                word &= ~mask;
+            }
+
+            if (level == 0 && word == prev_word)
+            {
+                return false;
+            }
+
+            // Summary of the next level changes only if this word became empty or stopped being empty
+            if ((prev_word == 0) == (word == 0))
+            {
+                break;
+            }
+
+            position /= kBitsPerWord;
+        }
+
+        return true;
+    }
+
+    constexpr void Clear()
+    {
+        words_.fill(0);
+    }
+
+    [[nodiscard]] constexpr bool Any() const noexcept
+    {
+        return GetWord(kLevelsCount - 1, 0) != 0;
+    }
+
+    [[nodiscard]] constexpr bool None() const noexcept
+    {
+        return !Any();
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes() const noexcept
+    {
+        size_t n = 0;
+        ForEachNonEmptyWord(
+            [&](size_t, const Word word)
+            {
+                n += static_cast<size_t>(std::popcount(word));
+            });
+        return n;
+    }
+
+    // Search functions return kSize if there is no matching bit
+
+    // Returns index of the first set bit at or after `from_index`
+    [[nodiscard]] constexpr size_t FindNextSet(const size_t from_index = 0) const noexcept
+    {
+        const size_t index = FindNextOnLevel(0, from_index);
+        return index == kInvalidIndex ? kSize : index;
+    }
+
+    // Returns index of the last set bit at or before `from_index`
+    [[nodiscard]] constexpr size_t FindPrevSet(const size_t from_index = kSize) const noexcept
+    {
+        if constexpr (kSize == 0)
+        {
+            return kSize;
+        }
+        else
+        {
+            size_t level = 0;
+            size_t position = std::min(from_index, kSize - 1);
+
+            // Climb until some word has a set bit at or before the position
+            while (true)
+            {
+                const size_t word_index = position / kBitsPerWord;
+                const size_t bit_index = position % kBitsPerWord;
+                const Word bits = GetWord(level, word_index) & (~Word{0} >> (kBitsPerWord - 1 - bit_index));
+                if (bits != 0)
+                {
+                    const size_t highest_bit = kBitsPerWord - 1 - static_cast<size_t>(std::countl_zero(bits));
+                    position = word_index * kBitsPerWord + highest_bit;
+                    break;
+                }
+
+                if (word_index == 0 || ++level == kLevelsCount)
+                {
+                    return kSize;
+                }
+
+                position = word_index - 1;
+            }
+
+            // Descend taking the last non-empty word on every level
+            while (level != 0)
+            {
+                const Word bits = GetWord(--level, position);
+                position = position * kBitsPerWord + kBitsPerWord - 1 - static_cast<size_t>(std::countl_zero(bits));
+            }
+
+            return position;
+        }
+    }
+
+    // Calls f(index) for every set bit in ascending order. Empty regions are skipped using summaries.
+    template <typename F>
+    constexpr void ForEachSetBit(F&& f) const
+    {
+        ForEachNonEmptyWord(
+            [&](const size_t word_index, Word word)
+            {
+                while (word != 0)
+                {
+                    const size_t bit_index = static_cast<size_t>(std::countr_zero(word));
+                    word &= word - 1;
+                    f(word_index * kBitsPerWord + bit_index);
+                }
+            });
+    }
+
+private:
+    [[nodiscard]] constexpr Word& GetWord(const size_t level, const size_t word_index) noexcept
+    {
+        return words_[Layout::kOffsets[level] + word_index];
+    }
+
+    [[nodiscard]] constexpr const Word& GetWord(const size_t level, const size_t word_index) const noexcept
+    {
+        return words_[Layout::kOffsets[level] + word_index];
+    }
+
+    // Returns position of the first set bit of the level at or after `position` or kInvalidIndex
+    [[nodiscard]] constexpr size_t FindNextOnLevel(const size_t start_level, size_t position) const noexcept
+    {
+        size_t level = start_level;
+
+        // Climb until some word has a set bit at or after the position
+        while (true)
+        {
+            if (position >= Layout::kBitsCount[level])
+            {
+                return kInvalidIndex;
+            }
+
+            const size_t word_index = position / kBitsPerWord;
+            const Word bits = GetWord(level, word_index) & (~Word{0} << (position % kBitsPerWord));
+            if (bits != 0)
+            {
+                position = word_index * kBitsPerWord + static_cast<size_t>(std::countr_zero(bits));
+                break;
+            }
+
+            if (++level == kLevelsCount)
+            {
+                return kInvalidIndex;
+            }
+
+            position = word_index + 1;
+        }
+
+        // Descend taking the first non-empty word on every level
+        while (level != start_level)
+        {
+            const Word bits = GetWord(--level, position);
+            position = position * kBitsPerWord + static_cast<size_t>(std::countr_zero(bits));
+        }
+
+        return position;
+    }
+
+    // Calls f(word_index, word) for every non-empty word of level 0
+    template <typename F>
+    constexpr void ForEachNonEmptyWord(F&& f) const
+    {
+        if constexpr (kLevelsCount == 1)
+        {
+            if (const Word word = GetWord(0, 0); word != 0)
+            {
+                f(size_t{0}, word);
+            }
+        }
+        else
+        {
+            for (size_t word_index = FindNextOnLevel(1, 0); word_index != kInvalidIndex;
+                 word_index = FindNextOnLevel(1, word_index + 1))
+            {
+                f(word_index, GetWord(0, word_index));
+            }
+        }
+    }
+
+private:
+    std::array<Word, Layout::kWordsCount> words_{};
+};
+}  // namespace ass
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "bit/bit_expression.hpp"
+#include "bit/bit_part.hpp"
+#include "bit/bit_range.hpp"
+
+namespace ass
+{
+// View of `size` bits that starts at an arbitrary bit of the first part.
+// Created by BitSpan::Subspan. Part-wide operations read and write every part of the view
+// with funnel shifts of two neighbor parts, so views with different offsets can be combined
+// in expressions without per-bit loops. Bits outside of the view are never modified.
+// Views with different offsets over the same memory must not overlap in one Assign.
+template <bit_part Part>
+class OffsetBitSpan
+{
+    using PurePart = std::remove_const_t<Part>;
+    static constexpr size_t kBitsPerPart = sizeof(Part) * 8;
+    static constexpr PurePart kAllOnes = std::numeric_limits<PurePart>::max();
+
+public:
+    static constexpr bool kCanModifyData = !std::is_const_v<Part>;
+
+    constexpr OffsetBitSpan(Part* parts, const size_t bit_offset, const size_t size) noexcept
+        : parts_(parts + bit_offset / kBitsPerPart),  // NOLINT
+          bit_offset_(bit_offset % kBitsPerPart),
+          size_(size)
+    {
+    }
+
+    [[nodiscard]] constexpr size_t GetSize() const noexcept
+    {
+        return size_;
+    }
+
+    // Offset of the first bit inside the first part, always less than the part width
+    [[nodiscard]] constexpr size_t GetBitOffset() const noexcept
+    {
+        return bit_offset_;
+    }
+
+    [[nodiscard]] friend constexpr OffsetBitPartsExpression<PurePart> ToBitExpression(
+        const OffsetBitSpan& span) noexcept
+    {
+        return OffsetBitPartsExpression<PurePart>(span.parts_, span.bit_offset_, span.size_);
+    }
+
+    [[nodiscard]] constexpr OffsetBitSpan Subspan(const size_t bit_offset, const size_t bit_count) const noexcept
+    {
+        assert(bit_offset + bit_count <= size_);
+        return OffsetBitSpan(parts_, bit_offset_ + bit_offset, bit_count);
+    }
+
+    [[nodiscard]] constexpr bool Get(const size_t index) const
+    {
+        assert(index < size_);
+        const size_t bit_index = bit_offset_ + index;
+        return (parts_[bit_index / kBitsPerPart] >> (bit_index % kBitsPerPart)) & 1;  // NOLINT
+    }
+
+    constexpr void Set(const size_t index, const bool value) const
+        requires(kCanModifyData)
+    {
+        assert(index < size_);
+        const size_t bit_index = bit_offset_ + index;
+        const PurePart mask = static_cast<PurePart>(PurePart{1} << (bit_index % kBitsPerPart));
+        StoreMasked(parts_[bit_index / kBitsPerPart], value ? mask : PurePart{0}, mask);  // NOLINT
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes() const
+    {
+        return bit_range_detail::CountOnesInRange<PurePart>(parts_, bit_offset_, bit_offset_ + size_);
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes(const size_t begin, const size_t end) const
+    {
+        assert(end <= size_);
+        return bit_range_detail::CountOnesInRange<PurePart>(parts_, bit_offset_ + begin, bit_offset_ + end);
+    }
+
+    [[nodiscard]] constexpr bool Any() const noexcept
+    {
+        return ToBitExpression(*this).Any();
+    }
+
+    [[nodiscard]] constexpr bool None() const noexcept
+    {
+        return !Any();
+    }
+
+    constexpr void SetRange(const size_t begin, const size_t end) const
+        requires(kCanModifyData)
+    {
+        assert(end <= size_);
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kSet>(parts_, bit_offset_ + begin, bit_offset_ + end);
+    }
+
+    constexpr void ResetRange(const size_t begin, const size_t end) const
+        requires(kCanModifyData)
+    {
+        assert(end <= size_);
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kReset>(
+            parts_,
+            bit_offset_ + begin,
+            bit_offset_ + end);
+    }
+
+    constexpr void FlipRange(const size_t begin, const size_t end) const
+        requires(kCanModifyData)
+    {
+        assert(end <= size_);
+        bit_range_detail::ModifyRange<bit_range_detail::RangeOp::kFlip>(parts_, bit_offset_ + begin, bit_offset_ + end);
+    }
+
+    // Returns GetSize() if there is no set bit at or after `from_index`
+    [[nodiscard]] constexpr size_t FindNextSet(const size_t from_index = 0) const noexcept
+    {
+        if (from_index >= size_) return size_;
+
+        const auto expression = ToBitExpression(*this);
+        const size_t parts_count = expression.GetPartsCount();
+        size_t part_index = from_index / kBitsPerPart;
+        const PurePart from_mask = static_cast<PurePart>(kAllOnes << (from_index % kBitsPerPart));
+        PurePart part = expression.GetMaskedPart(part_index) & from_mask;
+        while (part == 0)
+        {
+            if (++part_index == parts_count) return size_;
+            part = expression.GetMaskedPart(part_index);
+        }
+        return part_index * kBitsPerPart + static_cast<size_t>(bit_part_detail::CountRightZero(part));
+    }
+
+    // Evaluates lazy expression (see bit/bit_expression.hpp) and writes it part by part.
+    // Every logical part of the view lands in two neighbor parts of memory.
+    template <bit_expression Expression>
+    constexpr void Assign(const Expression& expression) const
+        requires(kCanModifyData)
+    {
+        static_assert(std::same_as<typename Expression::Part, PurePart>, "Expression must have the same part type");
+        assert(expression.GetSize() == size_);
+
+        const size_t parts_count = expression.GetPartsCount();
+        for (size_t part_index = 0; part_index != parts_count; ++part_index)
+        {
+            const size_t used_bits = std::min(kBitsPerPart, size_ - part_index * kBitsPerPart);
+            const PurePart used_mask =
+                used_bits == kBitsPerPart ? kAllOnes : static_cast<PurePart>(~(kAllOnes << used_bits));
+            const PurePart value = expression.GetPart(part_index);
+            if (bit_offset_ == 0)
+            {
+                StoreMasked(parts_[part_index], value, used_mask);  // NOLINT
+                continue;
+            }
+
+            StoreMasked(
+                parts_[part_index],  // NOLINT
+                static_cast<PurePart>(value << bit_offset_),
+                static_cast<PurePart>(used_mask << bit_offset_));
+
+            const PurePart high_mask = static_cast<PurePart>(used_mask >> (kBitsPerPart - bit_offset_));
+            if (high_mask != 0)
+            {
+                StoreMasked(
+                    parts_[part_index + 1],  // NOLINT
+                    static_cast<PurePart>(value >> (kBitsPerPart - bit_offset_)),
+                    high_mask);
+            }
+        }
+    }
+
+    template <bit_expression_operand Operand>
+    constexpr void AndAssign(const Operand& another) const
+        requires(kCanModifyData)
+    {
+        Assign(Lazy(*this) & another);
+    }
+
+    template <bit_expression_operand Operand>
+    constexpr void OrAssign(const Operand& another) const
+        requires(kCanModifyData)
+    {
+        Assign(Lazy(*this) | another);
+    }
+
+    template <bit_expression_operand Operand>
+    constexpr void XorAssign(const Operand& another) const
+        requires(kCanModifyData)
+    {
+        Assign(Lazy(*this) ^ another);
+    }
+
+private:
+    static constexpr void StoreMasked(PurePart& part, const PurePart value, const PurePart mask) noexcept
+    {
+        part = static_cast<PurePart>((part & ~mask) | (value & mask));
+    }
+
+private:
+    Part* parts_ = nullptr;
+    size_t bit_offset_ = 0;
+    size_t size_ = 0;
+};
+}  // namespace ass
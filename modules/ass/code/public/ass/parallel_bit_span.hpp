@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "bit/bit_part.hpp"
+#include "bit_span.hpp"
+
+namespace ass::parallel_bit_span_detail
+{
+inline constexpr size_t kCacheLineBytes = 64;
+
+// Smaller spans are processed by fewer threads: starting a thread costs about as much as scanning this
+inline constexpr size_t kMinBytesPerThread = 256 * 1024;
+
+// ParallelForEachSetBit hands out work in tasks of this size
+inline constexpr size_t kBytesPerTask = 64 * 1024;
+
+struct PartsRange
+{
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+// Splits parts [0, parts_count) into `chunks_count` contiguous ranges of nearly equal size.
+// Inner boundaries fall on cache line boundaries of the memory, so two chunks never share a cache line.
+// Some ranges may be empty when there are fewer cache lines than chunks.
+template <typename Part>
+[[nodiscard]] PartsRange GetChunk(
+    const Part* parts,
+    const size_t parts_count,
+    const size_t chunks_count,
+    const size_t chunk_index) noexcept
+{
+    constexpr size_t parts_per_line = kCacheLineBytes / sizeof(Part);
+    const size_t misalignment = reinterpret_cast<uintptr_t>(parts) % kCacheLineBytes / sizeof(Part);
+    const size_t lines_count = (misalignment + parts_count + parts_per_line - 1) / parts_per_line;
+
+    auto get_boundary = [&](const size_t index)
+    {
+        if (index == chunks_count) return parts_count;
+
+        const size_t line_begin = lines_count * index / chunks_count * parts_per_line;
+        return line_begin > misalignment ? std::min(line_begin - misalignment, parts_count) : size_t{0};
+    };
+
+    return {get_boundary(chunk_index), get_boundary(chunk_index + 1)};
+}
+
+// Calls fn(thread_index) on `threads_count` threads, one of them is the calling thread
+template <typename F>
+void RunInParallel(const size_t threads_count, F&& fn)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count - 1);
+    for (size_t thread_index = 1; thread_index != threads_count; ++thread_index)
+    {
+        threads.emplace_back(fn, thread_index);
+    }
+    fn(size_t{0});
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+template <typename Part>
+[[nodiscard]] size_t ClampThreadsCount(const size_t threads_count, const size_t parts_count) noexcept
+{
+    const size_t max_threads_count = std::max<size_t>(1, parts_count * sizeof(Part) / kMinBytesPerThread);
+    return std::clamp<size_t>(threads_count, 1, max_threads_count);
+}
+
+// Dynamic BitSpan over the parts of the range. Only the last chunk of the span may have unused bits.
+template <typename Part>
+[[nodiscard]] BitSpan<Part> MakeChunkSpan(Part* parts, const size_t size, const PartsRange& range) noexcept
+{
+    constexpr size_t bits_per_part = sizeof(Part) * 8;
+    const size_t bits_begin = range.begin * bits_per_part;
+    const size_t bits_end = std::min(range.end * bits_per_part, size);
+    return BitSpan<Part>(
+        parts + range.begin,  // NOLINT
+        {.parts_count = range.end - range.begin, .size = bits_end > bits_begin ? bits_end - bits_begin : 0});
+}
+
+// Applies fn(chunk_of_span, chunk_of_another) to every chunk on its own thread
+template <typename Part, typename AnotherPart, typename F>
+void ForEachChunkPair(
+    Part* parts,
+    AnotherPart* another_parts,
+    const size_t size,
+    const size_t parts_count,
+    size_t threads_count,
+    F&& fn)
+{
+    threads_count = ClampThreadsCount<Part>(threads_count, parts_count);
+    RunInParallel(
+        threads_count,
+        [&](const size_t thread_index)
+        {
+            const PartsRange range = GetChunk(parts, parts_count, threads_count, thread_index);
+            if (range.begin == range.end) return;
+
+            auto chunk = MakeChunkSpan(parts, size, range);
+            fn(chunk, MakeChunkSpan(another_parts, size, range));
+        });
+}
+}  // namespace ass::parallel_bit_span_detail
+
+namespace ass
+{
+// Parallel versions of BitSpan bulk operations for spans of millions and billions of bits.
+// Every thread gets a contiguous chunk that starts at a cache line boundary and runs the usual
+// (SIMD accelerated) single-threaded operation on it. Threads are started per call, so small spans
+// use fewer threads than requested, down to a plain single-threaded call.
+
+template <bit_part Part, BitSpanStaticExtents extents>
+[[nodiscard]] size_t ParallelCountOnes(const BitSpan<Part, extents>& span, size_t threads_count)
+{
+    namespace detail = parallel_bit_span_detail;
+    const size_t size = span.GetSize();
+    if (size == 0) return 0;
+
+    const Part* parts = &span.GetPart(0);
+    const size_t parts_count = (size + span.BitsPerPart() - 1) / span.BitsPerPart();
+    threads_count = detail::ClampThreadsCount<Part>(threads_count, parts_count);
+
+    std::vector<size_t> counts(threads_count);
+    detail::RunInParallel(
+        threads_count,
+        [&](const size_t thread_index)
+        {
+            const detail::PartsRange range = detail::GetChunk(parts, parts_count, threads_count, thread_index);
+            counts[thread_index] = detail::MakeChunkSpan(parts, size, range).CountOnes();
+        });
+
+    size_t n = 0;
+    for (const size_t count : counts) n += count;
+    return n;
+}
+
+template <bit_part Part, BitSpanStaticExtents extents, bit_span_detail::is_bit_span Another>
+void ParallelAndAssign(const BitSpan<Part, extents>& span, const Another& another, const size_t threads_count)
+    requires(BitSpan<Part, extents>::kCanModifyData)
+{
+    assert(span.GetSize() == another.GetSize());
+    const size_t size = span.GetSize();
+    if (size == 0) return;
+
+    parallel_bit_span_detail::ForEachChunkPair(
+        &span.GetPart(0),
+        &another.GetPart(0),
+        size,
+        (size + span.BitsPerPart() - 1) / span.BitsPerPart(),
+        threads_count,
+        [](auto& chunk, const auto& another_chunk)
+        {
+            chunk.AndAssign(another_chunk);
+        });
+}
+
+template <bit_part Part, BitSpanStaticExtents extents, bit_span_detail::is_bit_span Another>
+void ParallelOrAssign(const BitSpan<Part, extents>& span, const Another& another, const size_t threads_count)
+    requires(BitSpan<Part, extents>::kCanModifyData)
+{
+    assert(span.GetSize() == another.GetSize());
+    const size_t size = span.GetSize();
+    if (size == 0) return;
+
+    parallel_bit_span_detail::ForEachChunkPair(
+        &span.GetPart(0),
+        &another.GetPart(0),
+        size,
+        (size + span.BitsPerPart() - 1) / span.BitsPerPart(),
+        threads_count,
+        [](auto& chunk, const auto& another_chunk)
+        {
+            chunk.OrAssign(another_chunk);
+        });
+}
+
+template <bit_part Part, BitSpanStaticExtents extents, bit_span_detail::is_bit_span Another>
+void ParallelXorAssign(const BitSpan<Part, extents>& span, const Another& another, const size_t threads_count)
+    requires(BitSpan<Part, extents>::kCanModifyData)
+{
+    assert(span.GetSize() == another.GetSize());
+    const size_t size = span.GetSize();
+    if (size == 0) return;
+
+    parallel_bit_span_detail::ForEachChunkPair(
+        &span.GetPart(0),
+        &another.GetPart(0),
+        size,
+        (size + span.BitsPerPart() - 1) / span.BitsPerPart(),
+        threads_count,
+        [](auto& chunk, const auto& another_chunk)
+        {
+            chunk.XorAssign(another_chunk);
+        });
+}
+
+template <bit_part Part, BitSpanStaticExtents extents>
+void ParallelFlip(const BitSpan<Part, extents>& span, const size_t threads_count)
+    requires(BitSpan<Part, extents>::kCanModifyData)
+{
+    const size_t size = span.GetSize();
+    if (size == 0) return;
+
+    Part* parts = &span.GetPart(0);
+    parallel_bit_span_detail::ForEachChunkPair(
+        parts,
+        parts,
+        size,
+        (size + span.BitsPerPart() - 1) / span.BitsPerPart(),
+        threads_count,
+        [](auto& chunk, const auto&)
+        {
+            chunk.Flip();
+        });
+}
+
+// Calls f(index) for every set bit. Calls come from several threads at once and in no particular order,
+// though within one task indices ascend. The span is cut into small cache line aligned tasks which threads
+// grab from a shared counter, so a thread that got a sparse region picks up the work of dense ones.
+template <bit_part Part, BitSpanStaticExtents extents, typename F>
+void ParallelForEachSetBit(const BitSpan<Part, extents>& span, F&& f, size_t threads_count)
+{
+    namespace detail = parallel_bit_span_detail;
+    const size_t size = span.GetSize();
+    if (size == 0) return;
+
+    const Part* parts = &span.GetPart(0);
+    const size_t parts_count = (size + span.BitsPerPart() - 1) / span.BitsPerPart();
+    const size_t tasks_count = std::max<size_t>(1, parts_count * sizeof(Part) / detail::kBytesPerTask);
+    threads_count = std::min(detail::ClampThreadsCount<Part>(threads_count, parts_count), tasks_count);
+
+    std::atomic<size_t> next_task = 0;
+    detail::RunInParallel(
+        threads_count,
+        [&](size_t)
+        {
+            for (size_t task = next_task.fetch_add(1, std::memory_order_relaxed); task < tasks_count;
+                 task = next_task.fetch_add(1, std::memory_order_relaxed))
+            {
+                const detail::PartsRange range = detail::GetChunk(parts, parts_count, tasks_count, task);
+                const size_t bits_begin = range.begin * span.BitsPerPart();
+                detail::MakeChunkSpan(parts, size, range).ForEachSetBit(
+                    [&](const size_t index)
+                    {
+                        f(bits_begin + index);
+                    });
+            }
+        });
+}
+}  // namespace ass
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+namespace ass::probe_policy_detail
+{
+template <size_t capacity>
+inline constexpr size_t ToIndex(const size_t value)
+{
+    if constexpr (capacity == 0)
+    {
+        return 0;
+    }
+    else if constexpr (std::has_single_bit(capacity))
+    {
+        return value & (capacity - 1);
+    }
+    else
+    {
+        return value % capacity;
+    }
+}
+
+// Derives a second, mostly independent, hash value from the first one.
+// Fibonacci hashing: the multiplication spreads low bits into the high ones.
+inline constexpr size_t MakeSecondaryHash(const size_t hash)
+{
+    constexpr uint64_t kMultiplier = 0x9E37'79B9'7F4A'7C15;
+    const uint64_t h = static_cast<uint64_t>(hash) * kMultiplier;
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+}  // namespace ass::probe_policy_detail
+
+namespace ass
+{
+// Probe policies decide in which order FixedUnorderedMap visits slots when the first one is taken.
+// Each policy provides `Sequence<capacity>` which is constructed from the key hash and
+// has to visit every slot exactly once during the first `capacity` steps.
+
+// Visits start, start + 1, start + 2, ...
+// The cheapest sequence with the best locality but suffers from primary clustering with bad hashers.
+struct LinearProbing
+{
+    template <size_t capacity>
+    class Sequence
+    {
+    public:
+        constexpr explicit Sequence(const size_t hash) noexcept : index_(probe_policy_detail::ToIndex<capacity>(hash))
+        {
+        }
+
+        [[nodiscard]] constexpr size_t GetIndex() const noexcept
+        {
+            return index_;
+        }
+
+        constexpr void Next() noexcept
+        {
+            index_ = probe_policy_detail::ToIndex<capacity>(index_ + 1);
+        }
+
+    private:
+        size_t index_ = 0;
+    };
+};
+
+// Visits start, start + 1, start + 3, start + 6, ... (offsets are triangular numbers).
+// Breaks primary clustering while keeping the first few probes close to each other.
+// Triangular numbers visit every slot only when capacity is a power of two.
+struct QuadraticProbing
+{
+    template <size_t capacity>
+    class Sequence
+    {
+    public:
+        static_assert(
+            capacity == 0 || std::has_single_bit(capacity),
+            "QuadraticProbing requires capacity to be a power of two");
+
+        constexpr explicit Sequence(const size_t hash) noexcept : index_(probe_policy_detail::ToIndex<capacity>(hash))
+        {
+        }
+
+        [[nodiscard]] constexpr size_t GetIndex() const noexcept
+        {
+            return index_;
+        }
+
+        constexpr void Next() noexcept
+        {
+            ++step_;
+            index_ = probe_policy_detail::ToIndex<capacity>(index_ + step_);
+        }
+
+    private:
+        size_t index_ = 0;
+        size_t step_ = 0;
+    };
+};
+
+// Visits start, start + step, start + 2 * step, ... where step is derived from the secondary hash.
+// Keys that collide in the first slot most likely have different steps so both primary and
+// secondary clustering go away at the cost of worse locality.
+struct DoubleHashing
+{
+    template <size_t capacity>
+    class Sequence
+    {
+    public:
+        constexpr explicit Sequence(const size_t hash) noexcept
+            : index_(probe_policy_detail::ToIndex<capacity>(hash)),
+              step_(MakeStep(hash))
+        {
+        }
+
+        [[nodiscard]] constexpr size_t GetIndex() const noexcept
+        {
+            return index_;
+        }
+
+        constexpr void Next() noexcept
+        {
+            index_ = probe_policy_detail::ToIndex<capacity>(index_ + step_);
+        }
+
+    private:
+        // The step must be coprime with capacity, otherwise the sequence would not visit every slot
+        static constexpr size_t MakeStep(const size_t hash) noexcept
+        {
+            if constexpr (capacity <= 1)
+            {
+                return 0;
+            }
+            else
+            {
+                size_t step = 1 + probe_policy_detail::MakeSecondaryHash(hash) % (capacity - 1);
+                if constexpr (std::has_single_bit(capacity))
+                {
+                    step |= 1;
+                }
+                else
+                {
+                    while (std::gcd(step, capacity) != 1) ++step;
+                }
+                return step;
+            }
+        }
+
+    private:
+        size_t index_ = 0;
+        size_t step_ = 0;
+    };
+};
+}  // namespace ass
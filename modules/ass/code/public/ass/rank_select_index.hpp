@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "bit/bit_part.hpp"
+#include "bit_span.hpp"
+
+namespace ass::rank_select_index_detail
+{
+inline constexpr size_t kBlockBitsCount = 512;
+inline constexpr size_t kSuperblockBitsCount = 4096;
+inline constexpr size_t kBlocksPerSuperblock = kSuperblockBitsCount / kBlockBitsCount;
+
+// Select1 inventory: ones are grouped into chunks of kOnesPerChunk.
+// A chunk whose ones span less than kSparseChunkBitsCount bits is dense and keeps only the position of its first
+// one, the rest is found with the rank directory. Otherwise the chunk is sparse and keeps positions of all its ones.
+inline constexpr size_t kOnesPerChunk = 8192;
+inline constexpr size_t kSparseChunkBitsCount = size_t{1} << 25;
+
+template <bit_part Part>
+[[nodiscard]] constexpr size_t SelectInPart(Part part, size_t k) noexcept
+{
+    assert(k < static_cast<size_t>(bit_part_detail::PopCount(part)));
+    for (; k != 0; --k)
+    {
+        part &= static_cast<Part>(part - 1);
+    }
+    return static_cast<size_t>(bit_part_detail::CountRightZero(part));
+}
+}  // namespace ass::rank_select_index_detail
+
+namespace ass
+{
+// Rank/select directory over a BitSpan.
+// Keeps the number of ones before every 4096-bit superblock (64 bits each) and before every 512-bit block
+// relative to its superblock (16 bits each) - about 4.7% of the bitmap size.
+// Rank1 adds two counters and counts at most one block.
+// Select1 is constant time: it reads the inventory word of the chunk of 8192 ones that holds the answer.
+// A sparse chunk stores every position. A dense chunk spans less than 2^25 bits starting at its first one,
+// so the answer is found by a binary search over at most 8193 superblock counters (13 steps), a walk over at most
+// 7 block counters and a scan of one 512-bit block - bounds that do not depend on the bitmap size.
+// The inventory takes one word per chunk (at most 0.8% of the bitmap when all bits are set) and 64 bits per one
+// in sparse chunks (less than 1.6% of the bits they span), so rank and select together stay under 6.3%.
+// The index does not own the bits and must be rebuilt after the bits are modified.
+template <typename BitSpanT>
+    requires(bit_span_detail::is_bit_span<BitSpanT>)
+class RankSelectIndex
+{
+    static constexpr size_t kBlockBitsCount = rank_select_index_detail::kBlockBitsCount;
+    static constexpr size_t kSuperblockBitsCount = rank_select_index_detail::kSuperblockBitsCount;
+    static constexpr size_t kBlocksPerSuperblock = rank_select_index_detail::kBlocksPerSuperblock;
+    static constexpr size_t kOnesPerChunk = rank_select_index_detail::kOnesPerChunk;
+    static constexpr size_t kSparseChunkBitsCount = rank_select_index_detail::kSparseChunkBitsCount;
+
+public:
+    constexpr explicit RankSelectIndex(const BitSpanT& bits) : bits_(bits)
+    {
+        Rebuild();
+    }
+
+    constexpr void Rebuild()
+    {
+        const size_t size = GetSize();
+        const size_t blocks_count = (size + kBlockBitsCount - 1) / kBlockBitsCount;
+        const size_t superblocks_count = (size + kSuperblockBitsCount - 1) / kSuperblockBitsCount;
+        superblock_ranks_.assign(superblocks_count + 1, 0);
+        block_ranks_.assign(blocks_count, 0);
+
+        size_t n = 0;
+        for (size_t block_index = 0; block_index != blocks_count; ++block_index)
+        {
+            const size_t superblock_index = block_index / kBlocksPerSuperblock;
+            if (block_index % kBlocksPerSuperblock == 0)
+            {
+                superblock_ranks_[superblock_index] = n;
+            }
+
+            block_ranks_[block_index] = static_cast<uint16_t>(n - superblock_ranks_[superblock_index]);
+
+            const size_t begin = block_index * kBlockBitsCount;
+            n += bits_.CountOnes(begin, std::min(begin + kBlockBitsCount, size));
+        }
+
+        superblock_ranks_.back() = n;
+        RebuildSelectInventory();
+    }
+
+    [[nodiscard]] constexpr size_t GetSize() const noexcept
+    {
+        return bits_.GetSize();
+    }
+
+    [[nodiscard]] constexpr size_t CountOnes() const noexcept
+    {
+        return superblock_ranks_.back();
+    }
+
+    // Number of ones in [0, index)
+    [[nodiscard]] constexpr size_t Rank1(const size_t index) const
+    {
+        assert(index <= GetSize());
+        if (index == GetSize()) return CountOnes();
+
+        const size_t block_index = index / kBlockBitsCount;
+        const size_t block_begin = block_index * kBlockBitsCount;
+        return superblock_ranks_[index / kSuperblockBitsCount] + block_ranks_[block_index] +
+               bits_.CountOnes(block_begin, index);
+    }
+
+    // Number of zeros in [0, index)
+    [[nodiscard]] constexpr size_t Rank0(const size_t index) const
+    {
+        return index - Rank1(index);
+    }
+
+    // Position of the k-th one (counting from zero) or GetSize() if there are not enough ones
+    [[nodiscard]] constexpr size_t Select1(const size_t k) const
+    {
+        if (k >= CountOnes()) return GetSize();
+
+        const size_t inventory = chunk_inventory_[k / kOnesPerChunk];
+        if (inventory & kSparseChunkFlag)
+        {
+            return sparse_positions_[(inventory >> 1) + k % kOnesPerChunk];
+        }
+
+        return SelectInDenseChunk(inventory >> 1, k);
+    }
+
+private:
+    // Lowest bit of chunk inventory tells if the rest is an index in sparse_positions_ or the position
+    // of the first one of a dense chunk
+    static constexpr size_t kSparseChunkFlag = 1;
+
+    constexpr void RebuildSelectInventory()
+    {
+        chunk_inventory_.clear();
+        sparse_positions_.clear();
+
+        std::vector<size_t> chunk;
+        chunk.reserve(kOnesPerChunk);
+        auto flush_chunk = [&]
+        {
+            if (chunk.back() - chunk.front() < kSparseChunkBitsCount)
+            {
+                chunk_inventory_.push_back(chunk.front() << 1);
+            }
+            else
+            {
+                chunk_inventory_.push_back((sparse_positions_.size() << 1) | kSparseChunkFlag);
+                sparse_positions_.insert(sparse_positions_.end(), chunk.begin(), chunk.end());
+            }
+            chunk.clear();
+        };
+
+        bits_.ForEachSetBit(
+            [&](const size_t index)
+            {
+                chunk.push_back(index);
+                if (chunk.size() == kOnesPerChunk) flush_chunk();
+            });
+
+        if (!chunk.empty()) flush_chunk();
+    }
+
+    // Position of the k-th one of the bitmap, which belongs to a dense chunk starting at `chunk_begin`.
+    // Whole superblocks and blocks are skipped by their ranks, then parts of a single block are scanned.
+    [[nodiscard]] constexpr size_t SelectInDenseChunk(const size_t chunk_begin, const size_t k) const
+    {
+        // Last superblock with no more than k ones before it, among those the chunk can reach
+        const size_t first_superblock = chunk_begin / kSuperblockBitsCount;
+        const size_t superblocks_end = std::min(
+            superblock_ranks_.size() - 1,
+            first_superblock + kSparseChunkBitsCount / kSuperblockBitsCount + 1);
+        const auto superblock_it = std::upper_bound(
+            superblock_ranks_.begin() + static_cast<ptrdiff_t>(first_superblock),
+            superblock_ranks_.begin() + static_cast<ptrdiff_t>(superblocks_end),
+            k);
+        const size_t superblock_index = static_cast<size_t>(superblock_it - superblock_ranks_.begin()) - 1;
+        const size_t k_in_superblock = k - superblock_ranks_[superblock_index];
+
+        size_t block_index = superblock_index * kBlocksPerSuperblock;
+        const size_t blocks_end = std::min(block_ranks_.size(), block_index + kBlocksPerSuperblock);
+        while (block_index + 1 != blocks_end && block_ranks_[block_index + 1] <= k_in_superblock)
+        {
+            ++block_index;
+        }
+
+        return SelectFrom(block_index * kBlockBitsCount, k_in_superblock - block_ranks_[block_index]);
+    }
+
+    // Position of the k-th one at or after `position`. The caller guarantees it is in the same block.
+    [[nodiscard]] constexpr size_t SelectFrom(const size_t position, size_t k) const
+    {
+        constexpr size_t bits_per_part = BitSpanT::BitsPerPart();
+        using Part = std::remove_cvref_t<decltype(bits_.GetPart(0))>;
+
+        size_t part_index = position / bits_per_part;
+        constexpr auto kAllOnes = static_cast<Part>(~Part{0});
+        auto part = static_cast<Part>(bits_.GetPart(part_index) & (kAllOnes << (position % bits_per_part)));
+        while (true)
+        {
+            const size_t part_ones = static_cast<size_t>(bit_part_detail::PopCount(part));
+            if (k < part_ones)
+            {
+                return part_index * bits_per_part + rank_select_index_detail::SelectInPart(part, k);
+            }
+            k -= part_ones;
+            part = bits_.GetPart(++part_index);
+        }
+    }
+
+    BitSpanT bits_;
+    std::vector<size_t> superblock_ranks_;
+    std::vector<uint16_t> block_ranks_;
+    std::vector<size_t> chunk_inventory_;
+    std::vector<size_t> sparse_positions_;
+};
+}  // namespace ass
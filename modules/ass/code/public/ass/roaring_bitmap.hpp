@@ -0,0 +1,638 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "bit_span.hpp"
+
+namespace ass::roaring_bitmap_detail
+{
+inline constexpr size_t kChunkBitsCount = 65536;
+inline constexpr size_t kWordsCount = kChunkBitsCount / 64;
+
+// Sorted array takes 2 bytes per value and beats the 8 KB bitmap up to this size
+inline constexpr size_t kMaxArraySize = 4096;
+
+enum class ContainerKind : uint8_t
+{
+    kArray,
+    kBitmap,
+    kRun
+};
+
+// Values [start, start + length]
+struct Run
+{
+    uint16_t start = 0;
+    uint16_t length = 0;
+};
+
+using Words = std::vector<uint64_t>;
+
+[[nodiscard]] inline auto ToChunkBits(Words& words)
+{
+    assert(words.size() == kWordsCount);
+    return ToBitSpan<{.size = kChunkBitsCount}>(std::span<uint64_t, kWordsCount>(words));
+}
+
+[[nodiscard]] inline auto ToChunkBits(const Words& words)
+{
+    assert(words.size() == kWordsCount);
+    return ToBitSpan<{.size = kChunkBitsCount}>(std::span<const uint64_t, kWordsCount>(words));
+}
+
+// Low 16 bits of all values from one 64K chunk.
+// Stored as a sorted array, a bitmap of 1024 words viewed as BitSpan or a list of runs.
+// Array and bitmap switch automatically on Add/Remove, runs are created by Optimize.
+class Container
+{
+public:
+    [[nodiscard]] static Container FromArray(std::vector<uint16_t> values)
+    {
+        if (values.size() > kMaxArraySize)
+        {
+            Words words(kWordsCount, 0);
+            const auto bits = ToChunkBits(words);
+            for (const uint16_t value : values) bits.Set(value, true);
+            return FromWords(std::move(words), values.size());
+        }
+
+        Container r;
+        r.kind_ = ContainerKind::kArray;
+        r.cardinality_ = values.size();
+        r.array_ = std::move(values);
+        return r;
+    }
+
+    // Small results are converted to the array
+    [[nodiscard]] static Container FromWords(Words words, const size_t cardinality)
+    {
+        Container r;
+        r.kind_ = ContainerKind::kBitmap;
+        r.cardinality_ = cardinality;
+        r.words_ = std::move(words);
+        if (cardinality <= kMaxArraySize) r.ConvertToArray();
+        return r;
+    }
+
+    [[nodiscard]] ContainerKind GetKind() const noexcept
+    {
+        return kind_;
+    }
+
+    [[nodiscard]] size_t CountOnes() const noexcept
+    {
+        return cardinality_;
+    }
+
+    [[nodiscard]] size_t GetSizeInBytes() const noexcept
+    {
+        return array_.size() * sizeof(uint16_t) + words_.size() * sizeof(uint64_t) + runs_.size() * sizeof(Run);
+    }
+
+    [[nodiscard]] bool Contains(const uint16_t value) const
+    {
+        switch (kind_)
+        {
+        case ContainerKind::kArray:
+            return std::binary_search(array_.begin(), array_.end(), value);
+        case ContainerKind::kBitmap:
+            return ToChunkBits(words_).Get(value);
+        case ContainerKind::kRun:
+        {
+            auto it = std::upper_bound(
+                runs_.begin(),
+                runs_.end(),
+                value,
+                [](const uint16_t v, const Run& run)
+                {
+                    return v < run.start;
+                });
+            return it != runs_.begin() && value - std::prev(it)->start <= std::prev(it)->length;
+        }
+        }
+        return false;
+    }
+
+    // Returns true if the value was added
+    bool Add(const uint16_t value)
+    {
+        if (kind_ == ContainerKind::kRun) Materialize();
+
+        if (kind_ == ContainerKind::kArray)
+        {
+            auto it = std::lower_bound(array_.begin(), array_.end(), value);
+            if (it != array_.end() && *it == value) return false;
+            if (array_.size() == kMaxArraySize)
+            {
+                ConvertToBitmap();
+                return Add(value);
+            }
+            array_.insert(it, value);
+        }
+        else
+        {
+            const auto bits = ToChunkBits(words_);
+            if (bits.Get(value)) return false;
+            bits.Set(value, true);
+        }
+
+        ++cardinality_;
+        return true;
+    }
+
+    // Returns true if the value was removed
+    bool Remove(const uint16_t value)
+    {
+        if (kind_ == ContainerKind::kRun) Materialize();
+
+        if (kind_ == ContainerKind::kArray)
+        {
+            auto it = std::lower_bound(array_.begin(), array_.end(), value);
+            if (it == array_.end() || *it != value) return false;
+            array_.erase(it);
+            --cardinality_;
+        }
+        else
+        {
+            const auto bits = ToChunkBits(words_);
+            if (!bits.Get(value)) return false;
+            bits.Set(value, false);
+            if (--cardinality_ <= kMaxArraySize) ConvertToArray();
+        }
+
+        return true;
+    }
+
+    // Calls f(value) for every value in ascending order
+    template <typename F>
+    void ForEach(F&& f) const
+    {
+        switch (kind_)
+        {
+        case ContainerKind::kArray:
+            for (const uint16_t value : array_) f(value);
+            break;
+        case ContainerKind::kBitmap:
+            ToChunkBits(words_).ForEachSetBit(
+                [&](const size_t index)
+                {
+                    f(static_cast<uint16_t>(index));
+                });
+            break;
+        case ContainerKind::kRun:
+            for (const Run& run : runs_)
+            {
+                for (size_t value = run.start; value <= size_t{run.start} + run.length; ++value)
+                {
+                    f(static_cast<uint16_t>(value));
+                }
+            }
+            break;
+        }
+    }
+
+    // Dense copy of the container
+    [[nodiscard]] Words ToWords() const
+    {
+        if (kind_ == ContainerKind::kBitmap) return words_;
+
+        Words words(kWordsCount, 0);
+        const auto bits = ToChunkBits(words);
+        if (kind_ == ContainerKind::kArray)
+        {
+            for (const uint16_t value : array_) bits.Set(value, true);
+        }
+        else
+        {
+            for (const Run& run : runs_) bits.SetRange(run.start, size_t{run.start} + run.length + 1);
+        }
+        return words;
+    }
+
+    // Switches to the smallest of array, bitmap and runs
+    void Optimize()
+    {
+        if (kind_ == ContainerKind::kRun) Materialize();
+
+        const size_t runs_count = CountRuns();
+        const size_t runs_bytes = runs_count * sizeof(Run);
+        const size_t current_bytes = GetSizeInBytes();
+        if (runs_bytes >= current_bytes) return;
+
+        std::vector<Run> runs;
+        runs.reserve(runs_count);
+        ForEach(
+            [&](const uint16_t value)
+            {
+                if (!runs.empty() && size_t{runs.back().start} + runs.back().length + 1 == value)
+                {
+                    ++runs.back().length;
+                }
+                else
+                {
+                    runs.push_back({.start = value, .length = 0});
+                }
+            });
+
+        kind_ = ContainerKind::kRun;
+        runs_ = std::move(runs);
+        array_ = {};
+        words_ = {};
+    }
+
+    [[nodiscard]] static Container Union(const Container& a, const Container& b)
+    {
+        if (a.kind_ == ContainerKind::kArray && b.kind_ == ContainerKind::kArray)
+        {
+            std::vector<uint16_t> values;
+            values.reserve(a.array_.size() + b.array_.size());
+            std::set_union(
+                a.array_.begin(),
+                a.array_.end(),
+                b.array_.begin(),
+                b.array_.end(),
+                std::back_inserter(values));
+            return FromArray(std::move(values));
+        }
+
+        Words words = a.ToWords();
+        auto bits = ToChunkBits(words);
+        if (b.kind_ == ContainerKind::kBitmap)
+        {
+            bits.OrAssign(ToChunkBits(b.words_));
+        }
+        else
+        {
+            b.ForEachRange(
+                [&](const size_t begin, const size_t end)
+                {
+                    bits.SetRange(begin, end);
+                });
+        }
+        const size_t cardinality = bits.CountOnes();
+        return FromWords(std::move(words), cardinality);
+    }
+
+    [[nodiscard]] static Container Intersection(const Container& a, const Container& b)
+    {
+        if (a.kind_ == ContainerKind::kArray || b.kind_ == ContainerKind::kArray)
+        {
+            const bool a_is_array = a.kind_ == ContainerKind::kArray;
+            const Container& array = a_is_array ? a : b;
+            const Container& other = a_is_array ? b : a;
+            std::vector<uint16_t> values;
+            std::copy_if(
+                array.array_.begin(),
+                array.array_.end(),
+                std::back_inserter(values),
+                [&](const uint16_t value)
+                {
+                    return other.Contains(value);
+                });
+            return FromArray(std::move(values));
+        }
+
+        Words words = a.ToWords();
+        auto bits = ToChunkBits(words);
+        if (b.kind_ == ContainerKind::kBitmap)
+        {
+            bits.AndAssign(ToChunkBits(b.words_));
+        }
+        else
+        {
+            const Words b_words = b.ToWords();
+            bits.AndAssign(ToChunkBits(b_words));
+        }
+        const size_t cardinality = bits.CountOnes();
+        return FromWords(std::move(words), cardinality);
+    }
+
+    // Size of the intersection without building it
+    [[nodiscard]] static size_t AndCount(const Container& a, const Container& b)
+    {
+        if (a.kind_ == ContainerKind::kArray || b.kind_ == ContainerKind::kArray)
+        {
+            const bool a_is_array = a.kind_ == ContainerKind::kArray;
+            const Container& array = a_is_array ? a : b;
+            const Container& other = a_is_array ? b : a;
+            return static_cast<size_t>(std::count_if(
+                array.array_.begin(),
+                array.array_.end(),
+                [&](const uint16_t value)
+                {
+                    return other.Contains(value);
+                }));
+        }
+
+        if (a.kind_ == ContainerKind::kBitmap && b.kind_ == ContainerKind::kBitmap)
+        {
+            return ToChunkBits(a.words_).AndCount(ToChunkBits(b.words_));
+        }
+
+        const Words a_words = a.ToWords();
+        const Words b_words = b.ToWords();
+        return ToChunkBits(a_words).AndCount(ToChunkBits(b_words));
+    }
+
+private:
+    // Calls f(begin, end) for ranges of consecutive values. Single values of array are ranges too.
+    template <typename F>
+    void ForEachRange(F&& f) const
+    {
+        if (kind_ == ContainerKind::kRun)
+        {
+            for (const Run& run : runs_) f(size_t{run.start}, size_t{run.start} + run.length + 1);
+        }
+        else
+        {
+            ForEach(
+                [&](const uint16_t value)
+                {
+                    f(size_t{value}, size_t{value} + 1);
+                });
+        }
+    }
+
+    [[nodiscard]] size_t CountRuns() const
+    {
+        if (kind_ == ContainerKind::kArray)
+        {
+            size_t n = 0;
+            for (size_t index = 0; index != array_.size(); ++index)
+            {
+                n += index == 0 || array_[index - 1] + 1 != array_[index];
+            }
+            return n;
+        }
+
+        // Run starts where the bit is set and the previous one is not
+        size_t n = 0;
+        uint64_t carry = 0;
+        for (const uint64_t word : words_)
+        {
+            n += static_cast<size_t>(std::popcount(word & ~((word << 1) | carry)));
+            carry = word >> 63;
+        }
+        return n;
+    }
+
+    // Converts runs to array or bitmap
+    void Materialize()
+    {
+        assert(kind_ == ContainerKind::kRun);
+        Words words = ToWords();
+        runs_ = {};
+        kind_ = ContainerKind::kBitmap;
+        words_ = std::move(words);
+        if (cardinality_ <= kMaxArraySize) ConvertToArray();
+    }
+
+    void ConvertToArray()
+    {
+        assert(kind_ == ContainerKind::kBitmap);
+        std::vector<uint16_t> values;
+        values.reserve(cardinality_);
+        ForEach(
+            [&](const uint16_t value)
+            {
+                values.push_back(value);
+            });
+        kind_ = ContainerKind::kArray;
+        array_ = std::move(values);
+        words_ = {};
+    }
+
+    void ConvertToBitmap()
+    {
+        assert(kind_ == ContainerKind::kArray);
+        words_ = ToWords();
+        kind_ = ContainerKind::kBitmap;
+        array_ = {};
+    }
+
+private:
+    ContainerKind kind_ = ContainerKind::kArray;
+    size_t cardinality_ = 0;
+    std::vector<uint16_t> array_;
+    Words words_;
+    std::vector<Run> runs_;
+};
+}  // namespace ass::roaring_bitmap_detail
+
+namespace ass
+{
+// Compressed set of 32-bit values for sparse data.
+// Values are split into 64K chunks by the high 16 bits. Every non-empty chunk keeps its low 16 bits
+// in the cheapest container: sorted array (up to 4096 values), bitmap (a BitSpan over 1024 words)
+// or runs of consecutive values (after Optimize). Union and intersection work chunk by chunk
+// and use word-wide BitSpan operations when both chunks are dense.
+class RoaringBitmap
+{
+    using Container = roaring_bitmap_detail::Container;
+
+public:
+    RoaringBitmap() = default;
+
+    // Returns true if the value was added
+    bool Add(const uint32_t value)
+    {
+        const auto [key, low] = Split(value);
+        auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+        const auto index = it - keys_.begin();
+        if (it == keys_.end() || *it != key)
+        {
+            keys_.insert(it, key);
+            containers_.insert(containers_.begin() + index, Container{});
+        }
+        return containers_[static_cast<size_t>(index)].Add(low);
+    }
+
+    // Returns true if the value was removed
+    bool Remove(const uint32_t value)
+    {
+        const auto [key, low] = Split(value);
+        const size_t index = FindChunk(key);
+        if (index == keys_.size()) return false;
+
+        Container& container = containers_[index];
+        if (!container.Remove(low)) return false;
+
+        if (container.CountOnes() == 0)
+        {
+            keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(index));
+            containers_.erase(containers_.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool Contains(const uint32_t value) const
+    {
+        const auto [key, low] = Split(value);
+        const size_t index = FindChunk(key);
+        return index != keys_.size() && containers_[index].Contains(low);
+    }
+
+    [[nodiscard]] size_t CountOnes() const noexcept
+    {
+        size_t n = 0;
+        for (const Container& container : containers_) n += container.CountOnes();
+        return n;
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept
+    {
+        return keys_.empty();
+    }
+
+    // Memory used by the containers payload
+    [[nodiscard]] size_t GetSizeInBytes() const noexcept
+    {
+        size_t n = keys_.size() * sizeof(uint16_t);
+        for (const Container& container : containers_) n += container.GetSizeInBytes();
+        return n;
+    }
+
+    // Converts every chunk to the smallest representation, including runs
+    void Optimize()
+    {
+        for (Container& container : containers_) container.Optimize();
+    }
+
+    // Calls f(value) for every value in ascending order
+    template <typename F>
+    void ForEach(F&& f) const
+    {
+        for (size_t index = 0; index != keys_.size(); ++index)
+        {
+            const uint32_t high = uint32_t{keys_[index]} << 16;
+            containers_[index].ForEach(
+                [&](const uint16_t low)
+                {
+                    f(high | low);
+                });
+        }
+    }
+
+    [[nodiscard]] size_t AndCount(const RoaringBitmap& another) const
+    {
+        size_t n = 0;
+        ForEachCommonChunk(
+            another,
+            [&](const size_t, const Container& a, const Container& b)
+            {
+                n += Container::AndCount(a, b);
+            });
+        return n;
+    }
+
+    [[nodiscard]] size_t OrCount(const RoaringBitmap& another) const
+    {
+        return CountOnes() + another.CountOnes() - AndCount(another);
+    }
+
+    [[nodiscard]] friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b)
+    {
+        RoaringBitmap r;
+        a.ForEachCommonChunk(
+            b,
+            [&](const size_t index, const Container& ca, const Container& cb)
+            {
+                Container container = Container::Intersection(ca, cb);
+                if (container.CountOnes() == 0) return;
+                r.keys_.push_back(a.keys_[index]);
+                r.containers_.push_back(std::move(container));
+            });
+        return r;
+    }
+
+    [[nodiscard]] friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b)
+    {
+        RoaringBitmap r;
+        r.keys_.reserve(a.keys_.size() + b.keys_.size());
+        r.containers_.reserve(a.keys_.size() + b.keys_.size());
+
+        size_t ia = 0;
+        size_t ib = 0;
+        while (ia != a.keys_.size() || ib != b.keys_.size())
+        {
+            if (ib == b.keys_.size() || (ia != a.keys_.size() && a.keys_[ia] < b.keys_[ib]))
+            {
+                r.keys_.push_back(a.keys_[ia]);
+                r.containers_.push_back(a.containers_[ia++]);
+            }
+            else if (ia == a.keys_.size() || b.keys_[ib] < a.keys_[ia])
+            {
+                r.keys_.push_back(b.keys_[ib]);
+                r.containers_.push_back(b.containers_[ib++]);
+            }
+            else
+            {
+                r.keys_.push_back(a.keys_[ia]);
+                r.containers_.push_back(Container::Union(a.containers_[ia++], b.containers_[ib++]));
+            }
+        }
+        return r;
+    }
+
+    RoaringBitmap& operator&=(const RoaringBitmap& another)
+    {
+        return *this = *this & another;
+    }
+
+    RoaringBitmap& operator|=(const RoaringBitmap& another)
+    {
+        return *this = *this | another;
+    }
+
+private:
+    [[nodiscard]] static std::pair<uint16_t, uint16_t> Split(const uint32_t value) noexcept
+    {
+        return {static_cast<uint16_t>(value >> 16), static_cast<uint16_t>(value & 0xFFFF)};
+    }
+
+    // Returns keys_.size() if there is no such chunk
+    [[nodiscard]] size_t FindChunk(const uint16_t key) const noexcept
+    {
+        auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+        if (it == keys_.end() || *it != key) return keys_.size();
+        return static_cast<size_t>(it - keys_.begin());
+    }
+
+    // Calls f(index_in_this, this_container, another_container) for chunks present in both bitmaps
+    template <typename F>
+    void ForEachCommonChunk(const RoaringBitmap& another, F&& f) const
+    {
+        size_t ia = 0;
+        size_t ib = 0;
+        while (ia != keys_.size() && ib != another.keys_.size())
+        {
+            if (keys_[ia] < another.keys_[ib])
+            {
+                ++ia;
+            }
+            else if (another.keys_[ib] < keys_[ia])
+            {
+                ++ib;
+            }
+            else
+            {
+                f(ia, containers_[ia], another.containers_[ib]);
+                ++ia;
+                ++ib;
+            }
+        }
+    }
+
+private:
+    std::vector<uint16_t> keys_;
+    std::vector<Container> containers_;
+};
+}  // namespace ass
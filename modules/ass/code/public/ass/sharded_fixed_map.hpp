@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include "fixed_unordered_map.hpp"
+#include "probe_policy.hpp"
+
+namespace ass::sharded_fixed_map_detail
+{
+// Test-and-test-and-set lock. Critical sections of the map are a few probes long,
+// so spinning is cheaper than putting the thread to sleep.
+class SpinLock
+{
+public:
+    void lock() noexcept  // NOLINT
+    {
+        while (flag_.exchange(true, std::memory_order_acquire))
+        {
+            while (flag_.load(std::memory_order_relaxed))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool try_lock() noexcept  // NOLINT
+    {
+        return !flag_.load(std::memory_order_relaxed) && !flag_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept  // NOLINT
+    {
+        flag_.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<bool> flag_ = false;
+};
+
+// Shards are aligned to avoid false sharing between locks of neighbour shards
+inline constexpr size_t kShardAlignment = 64;
+}  // namespace ass::sharded_fixed_map_detail
+
+namespace ass
+{
+
+// Thread safe map built from independent FixedUnorderedMap shards, each guarded by its own spin lock.
+// A key is routed to a shard by the high bits of its mixed hash while the shard itself uses the low bits,
+// so keys of one shard are still spread over all of its slots.
+// The object is big by design - allocate it on the heap.
+template <
+    size_t shards_count,
+    size_t shard_capacity,
+    typename Key_,
+    typename Value_,
+    typename Hasher_,
+    typename ProbePolicy_ = LinearProbing>
+    requires(std::has_single_bit(shards_count))
+class ShardedFixedMap
+{
+public:
+    using Key = Key_;
+    using Value = Value_;
+    using Hasher = Hasher_;
+    using ProbePolicy = ProbePolicy_;
+    using ShardMap = FixedUnorderedMap<shard_capacity, Key, Value, Hasher, ProbePolicy>;
+
+    static constexpr size_t kShardsCount = shards_count;
+
+    static constexpr size_t Capacity() noexcept
+    {
+        return shards_count * shard_capacity;
+    }
+
+    static size_t GetShardIndex(const Key& key)
+    {
+        if constexpr (shards_count == 1)
+        {
+            return 0;
+        }
+        else
+        {
+            constexpr size_t shift = 64 - std::countr_zero(shards_count);
+            const uint64_t mixed = probe_policy_detail::MakeSecondaryHash(Hasher{}(key));
+            return static_cast<size_t>(mixed >> shift);
+        }
+    }
+
+    // Adds or overwrites the value. Returns false if the shard of the key is full.
+    bool TryAdd(const Key& key, Value value)
+    {
+        return WithLockedShard(
+            key,
+            [&](ShardMap& map)
+            {
+                return map.TryAdd(key, std::move(value)) != nullptr;
+            });
+    }
+
+    [[nodiscard]] std::optional<Value> Find(const Key& key) const
+    {
+        return WithLockedShard(
+            key,
+            [&](const ShardMap& map) -> std::optional<Value>
+            {
+                if (const Value* value = map.Find(key))
+                {
+                    return *value;
+                }
+
+                return std::nullopt;
+            });
+    }
+
+    [[nodiscard]] bool Contains(const Key& key) const
+    {
+        return WithLockedShard(
+            key,
+            [&](const ShardMap& map)
+            {
+                return map.Contains(key);
+            });
+    }
+
+    std::optional<Value> Remove(const Key& key)
+    {
+        return WithLockedShard(
+            key,
+            [&](ShardMap& map)
+            {
+                return map.Remove(key);
+            });
+    }
+
+    // Not a snapshot: shards are locked one at a time
+    [[nodiscard]] size_t Size() const
+    {
+        size_t n = 0;
+        for (const Shard& shard : shards_)
+        {
+            std::lock_guard lock(shard.lock);
+            n += shard.map.Size();
+        }
+        return n;
+    }
+
+    // Calls f(ShardMap&) with the shard of the key locked. Use it for compound operations on one key.
+    template <typename F>
+    decltype(auto) WithLockedShard(const Key& key, F&& f)
+    {
+        Shard& shard = shards_[GetShardIndex(key)];
+        std::lock_guard lock(shard.lock);
+        return f(shard.map);
+    }
+
+    template <typename F>
+    decltype(auto) WithLockedShard(const Key& key, F&& f) const
+    {
+        const Shard& shard = shards_[GetShardIndex(key)];
+        std::lock_guard lock(shard.lock);
+        return f(shard.map);
+    }
+
+    // Inserts all (key, value) pairs from the range using `threads_count` threads.
+    // First every thread routes its chunk of the input to per-shard buckets, then every thread fills
+    // its own subset of shards from all buckets. Shards are never shared between threads so there is no contention.
+    // Returns false if some keys did not fit into their shards.
+    template <std::ranges::random_access_range Range>
+    bool ParallelBuild(const Range& range, size_t threads_count)
+    {
+        const size_t items_count = static_cast<size_t>(std::ranges::size(range));
+        threads_count = std::clamp<size_t>(threads_count, 1, shards_count);
+
+        // buckets[thread_index][shard_index] - indices of range elements
+        std::vector<std::vector<std::vector<size_t>>> buckets(threads_count);
+        std::atomic<bool> all_fit = true;
+
+        auto run_in_parallel = [&](auto&& fn)
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(threads_count - 1);
+            for (size_t thread_index = 1; thread_index != threads_count; ++thread_index)
+            {
+                threads.emplace_back(fn, thread_index);
+            }
+            fn(size_t{0});
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        };
+
+        run_in_parallel(
+            [&](const size_t thread_index)
+            {
+                auto& thread_buckets = buckets[thread_index];
+                thread_buckets.resize(shards_count);
+                const size_t begin = items_count * thread_index / threads_count;
+                const size_t end = items_count * (thread_index + 1) / threads_count;
+                for (size_t item_index = begin; item_index != end; ++item_index)
+                {
+                    const auto& [key, value] = range[item_index];
+                    thread_buckets[GetShardIndex(key)].push_back(item_index);
+                }
+            });
+
+        run_in_parallel(
+            [&](const size_t thread_index)
+            {
+                for (size_t shard_index = thread_index; shard_index < shards_count; shard_index += threads_count)
+                {
+                    Shard& shard = shards_[shard_index];
+                    std::lock_guard lock(shard.lock);
+                    for (const auto& thread_buckets : buckets)
+                    {
+                        for (const size_t item_index : thread_buckets[shard_index])
+                        {
+                            const auto& [key, value] = range[item_index];
+                            if (!shard.map.TryAdd(key, value))
+                            {
+                                all_fit.store(false, std::memory_order_relaxed);
+                            }
+                        }
+                    }
+                }
+            });
+
+        return all_fit.load();
+    }
+
+private:
+    struct alignas(sharded_fixed_map_detail::kShardAlignment) Shard
+    {
+        mutable sharded_fixed_map_detail::SpinLock lock;
+        ShardMap map{};
+    };
+
+    std::array<Shard, shards_count> shards_{};
+};
+}  // namespace ass